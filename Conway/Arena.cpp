@@ -0,0 +1,93 @@
+#include "Arena.h"
+
+//Chunks double as freelist links while they sit unused, so they have to be
+//big (and aligned) enough to hold a pointer.
+static size_t roundChunk(size_t bytes)
+{
+    if (bytes < sizeof(void*)) bytes = sizeof(void*);
+    return (bytes + 7) & ~(size_t)7;
+}
+
+Arena::~Arena()
+{
+    for (size_t b = 0; b < this->blocks.size(); b++)
+    {
+        delete[] this->blocks[b].data;
+    }
+}
+
+void* Arena::allocate(size_t bytes)
+{
+    bytes = roundChunk(bytes);
+    this->allocations++;
+
+    for (size_t f = 0; f < this->freeLists.size(); f++)
+    {
+        if (this->freeLists[f].bytes != bytes || !this->freeLists[f].head) continue;
+
+        void* chunk = this->freeLists[f].head;
+        this->freeLists[f].head = *(void**)chunk;
+        this->freelistHits++;
+        return chunk;
+    }
+
+    //Bump out of the current block, walking forward (never back) through the
+    //blocks a reset() made reusable.
+    while (this->currentBlock < this->blocks.size()
+        && this->blocks[this->currentBlock].capacity - this->used < bytes)
+    {
+        this->currentBlock++;
+        this->used = 0;
+    }
+
+    if (this->currentBlock == this->blocks.size())
+    {
+        Block block;
+        block.capacity = bytes > blockBytes ? bytes : blockBytes;
+        block.data = new char[block.capacity];
+        this->blocks.push_back(block);
+        this->used = 0;
+    }
+
+    void* chunk = this->blocks[this->currentBlock].data + this->used;
+    this->used += bytes;
+    return chunk;
+}
+
+void Arena::release(void* chunk, size_t bytes)
+{
+    bytes = roundChunk(bytes);
+
+    for (size_t f = 0; f < this->freeLists.size(); f++)
+    {
+        if (this->freeLists[f].bytes != bytes) continue;
+
+        *(void**)chunk = this->freeLists[f].head;
+        this->freeLists[f].head = chunk;
+        return;
+    }
+
+    *(void**)chunk = nullptr;
+
+    FreeList list;
+    list.bytes = bytes;
+    list.head = chunk;
+    this->freeLists.push_back(list);
+}
+
+void Arena::reset()
+{
+    this->currentBlock = 0;
+    this->used = 0;
+    this->freeLists.clear();
+}
+
+size_t Arena::getReservedBytes() const
+{
+    size_t total = 0;
+    for (size_t b = 0; b < this->blocks.size(); b++)
+    {
+        total += this->blocks[b].capacity;
+    }
+    return total;
+}
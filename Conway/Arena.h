@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//Pooled allocator for engines that churn through small fixed-size nodes
+//(the sparse world's tiles today). Fresh chunks are bump-allocated out of
+//megabyte blocks; released chunks go onto a freelist keyed by their size and
+//are handed straight back on the next allocation of that size, so a
+//steady-state simulation stops touching the heap entirely instead of
+//fragmenting it over a day-long run. reset() makes every block reusable at
+//once for a world clear. The counters are exposed so the benchmark can
+//report hit rates next to generations/sec.
+class Arena
+{
+    static const size_t blockBytes = 1 << 20;
+
+    struct Block
+    {
+        char* data;
+        size_t capacity;
+    };
+
+    std::vector<Block> blocks;
+    size_t currentBlock = 0;
+    size_t used = 0;            //bytes handed out of the current block
+
+    //We only ever see a handful of distinct chunk sizes, so a small linear
+    //table beats a map here.
+    struct FreeList
+    {
+        size_t bytes;
+        void* head;
+    };
+
+    std::vector<FreeList> freeLists;
+
+    std::uint64_t allocations = 0;
+    std::uint64_t freelistHits = 0;
+
+public:
+
+    Arena() {}
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes);
+
+    //O(1): the chunk becomes the head of its size's freelist. The memory
+    //stays owned by the arena; nothing goes back to the heap before
+    //destruction.
+    void release(void* chunk, size_t bytes);
+
+    //Whole-arena reset: every block becomes reusable and the freelists are
+    //dropped. Invalidates everything ever allocated from this arena.
+    void reset();
+
+    std::uint64_t getAllocations() const { return this->allocations; }
+    std::uint64_t getFreelistHits() const { return this->freelistHits; }
+    size_t getBlockCount() const { return this->blocks.size(); }
+    size_t getReservedBytes() const;
+};
@@ -0,0 +1,198 @@
+#include "BitGrid.h"
+
+#include <algorithm>
+#include <bitset>
+
+BitGrid::BitGrid(int size)
+    : size(size)
+    , wordsPerRow((size + 63) / 64)
+    , words((size_t)size * ((size + 63) / 64), 0)
+{
+    int usedBits = size % 64;
+    this->lastWordMask = usedBits == 0 ? ~(std::uint64_t)0 : (((std::uint64_t)1 << usedBits) - 1);
+}
+
+void BitGrid::clear()
+{
+    std::fill(this->words.begin(), this->words.end(), 0);
+}
+
+//Fetch the cells one column to the left/right of word w, pulling the bit that
+//crosses the word boundary in from the adjacent word. Bit j of word w is
+//column w * 64 + j, so the col-1 neighbours are a shift towards the high bits.
+static std::uint64_t colLeft(const std::uint64_t* row, int w)
+{
+    std::uint64_t result = row[w] << 1;
+    if (w > 0) result |= row[w - 1] >> 63;
+    return result;
+}
+
+static std::uint64_t colRight(const std::uint64_t* row, int w, int wordsPerRow)
+{
+    std::uint64_t result = row[w] >> 1;
+    if (w + 1 < wordsPerRow) result |= row[w + 1] << 63;
+    return result;
+}
+
+void BitGrid::step(BitGrid& out) const
+{
+    CellTally tally;
+    this->stepRows(out, 0, this->size, tally);
+}
+
+//One row of the next generation from its three source rows (null rows are
+//off-board). Same three-plane full-adder as stepRows, minus the tally - the
+//fused path only tallies the final generation.
+static void stepRowWords(const std::uint64_t* above, const std::uint64_t* curr,
+                         const std::uint64_t* below, std::uint64_t* dst,
+                         int wordsPerRow, std::uint64_t lastWordMask)
+{
+    for (int w = 0; w < wordsPerRow; w++)
+    {
+        std::uint64_t ones = 0, twos = 0, fours = 0;
+
+        auto add = [&](std::uint64_t n)
+        {
+            std::uint64_t carry = ones & n;
+            ones ^= n;
+            fours |= twos & carry;
+            twos ^= carry;
+        };
+
+        if (above)
+        {
+            add(colLeft(above, w));
+            add(above[w]);
+            add(colRight(above, w, wordsPerRow));
+        }
+        add(colLeft(curr, w));
+        add(colRight(curr, w, wordsPerRow));
+        if (below)
+        {
+            add(colLeft(below, w));
+            add(below[w]);
+            add(colRight(below, w, wordsPerRow));
+        }
+
+        std::uint64_t next = ~fours & twos & (ones | curr[w]);
+        if (w == wordsPerRow - 1) next &= lastWordMask;
+        dst[w] = next;
+    }
+}
+
+void BitGrid::stepRowsFused(BitGrid& out, int steps, int rowBegin, int rowEnd, CellTally& tally) const
+{
+    //Sub-bands sized so the two scratch buffers stay around 256 KB together:
+    //the intermediate generations then live in L2 no matter how wide the
+    //caller's range is.
+    int bandRows = (int)((size_t)128 * 1024 / ((size_t)this->wordsPerRow * 8));
+    if (bandRows < 2 * steps + 1) bandRows = 2 * steps + 1;
+
+    //Scratch covers the band plus a `steps`-row halo on each side; board row
+    //r lives at scratch row r - base.
+    std::vector<std::uint64_t> bufA((size_t)(bandRows + 2 * steps) * this->wordsPerRow);
+    std::vector<std::uint64_t> bufB(bufA.size());
+
+    for (int bandBegin = rowBegin; bandBegin < rowEnd; bandBegin += bandRows)
+    {
+        int bandEnd = std::min(bandBegin + bandRows, rowEnd);
+        int base = bandBegin - steps;
+
+        std::uint64_t* src = bufA.data();
+        std::uint64_t* dst = bufB.data();
+
+        //Each generation is valid one row less into the halo on each side,
+        //and the halo was sized so the last one lands exactly on the band.
+        //The first generation reads the front buffer directly and the last
+        //writes straight into out, so the band passes through DRAM once in
+        //each direction no matter how many steps are fused.
+        for (int s = 1; s <= steps; s++)
+        {
+            int validBegin = std::max(base + s, 0);
+            int validEnd = std::min(bandEnd + steps - s, this->size);
+            bool last = s == steps;
+
+            for (int r = validBegin; r < validEnd; r++)
+            {
+                const std::uint64_t* curr = s == 1
+                    ? this->row(r) : src + (size_t)(r - base) * this->wordsPerRow;
+                //Rows are contiguous in both the grid and the scratch, so
+                //the neighbours are one row's worth of words away either way.
+                const std::uint64_t* above = r > 0 ? curr - this->wordsPerRow : nullptr;
+                const std::uint64_t* below = r + 1 < this->size
+                    ? curr + this->wordsPerRow : nullptr;
+                std::uint64_t* to = last
+                    ? out.row(r) : dst + (size_t)(r - base) * this->wordsPerRow;
+
+                stepRowWords(above, curr, below, to, this->wordsPerRow, this->lastWordMask);
+
+                if (last)
+                {
+                    //Births/deaths compare the finished generation against
+                    //the front buffer, i.e. `steps` generations back.
+                    const std::uint64_t* oldRow = this->row(r);
+                    for (int w = 0; w < this->wordsPerRow; w++)
+                    {
+                        tally.population += std::bitset<64>(to[w]).count();
+                        tally.births += std::bitset<64>(to[w] & ~oldRow[w]).count();
+                        tally.deaths += std::bitset<64>(oldRow[w] & ~to[w]).count();
+                    }
+                }
+            }
+            std::swap(src, dst);
+        }
+    }
+}
+
+void BitGrid::stepRows(BitGrid& out, int rowBegin, int rowEnd, CellTally& tally) const
+{
+    for (int r = rowBegin; r < rowEnd; r++)
+    {
+        const std::uint64_t* above = r > 0 ? this->row(r - 1) : nullptr;
+        const std::uint64_t* curr  = this->row(r);
+        const std::uint64_t* below = r + 1 < this->size ? this->row(r + 1) : nullptr;
+        std::uint64_t* dst = out.row(r);
+
+        for (int w = 0; w < this->wordsPerRow; w++)
+        {
+            //Neighbour counts of all 64 cells at once, kept in three bit
+            //planes (ones, twos, fours); fours saturates, which is fine
+            //because any count above 3 kills the cell anyway.
+            std::uint64_t ones = 0, twos = 0, fours = 0;
+
+            auto add = [&](std::uint64_t n)
+            {
+                std::uint64_t carry = ones & n;
+                ones ^= n;
+                fours |= twos & carry;
+                twos ^= carry;
+            };
+
+            if (above)
+            {
+                add(colLeft(above, w));
+                add(above[w]);
+                add(colRight(above, w, this->wordsPerRow));
+            }
+            add(colLeft(curr, w));
+            add(colRight(curr, w, this->wordsPerRow));
+            if (below)
+            {
+                add(colLeft(below, w));
+                add(below[w]);
+                add(colRight(below, w, this->wordsPerRow));
+            }
+
+            //A cell is alive next generation when the count is exactly 3, or
+            //exactly 2 and it is alive now.
+            std::uint64_t next = ~fours & twos & (ones | curr[w]);
+            if (w == this->wordsPerRow - 1) next &= this->lastWordMask;
+            dst[w] = next;
+
+            //Word-level popcounts while next is still in a register.
+            tally.population += std::bitset<64>(next).count();
+            tally.births += std::bitset<64>(next & ~curr[w]).count();
+            tally.deaths += std::bitset<64>(curr[w] & ~next).count();
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+
+static const char* phaseNames[FrameStats::PhaseCount] = { "sim", "rebuild", "draw", "swap" };
+
+FrameStats::~FrameStats()
+{
+    if (this->csv) fclose(this->csv);
+}
+
+void FrameStats::addFrame(const double seconds[PhaseCount])
+{
+    for (int p = 0; p < PhaseCount; p++)
+    {
+        this->samples[p][this->head] = seconds[p];
+    }
+    this->head = (this->head + 1) % historySize;
+    if (this->count < historySize) this->count++;
+
+    if (this->csv)
+    {
+        fprintf(this->csv, "%llu,%.6f,%.6f,%.6f,%.6f\n",
+            (unsigned long long)this->frame,
+            seconds[Simulate], seconds[Rebuild], seconds[Draw], seconds[Swap]);
+    }
+    this->frame++;
+}
+
+double FrameStats::percentile(Phase phase, double p) const
+{
+    if (this->count == 0) return 0.0;
+
+    this->sorted.assign(this->samples[phase], this->samples[phase] + this->count);
+
+    int nth = (int)(p / 100.0 * (this->count - 1) + 0.5);
+    std::nth_element(this->sorted.begin(), this->sorted.begin() + nth, this->sorted.end());
+    return this->sorted[nth];
+}
+
+std::string FrameStats::summary() const
+{
+    char line[256];
+    std::string result;
+
+    for (int p = 0; p < PhaseCount; p++)
+    {
+        snprintf(line, sizeof(line), "%s%s %.2f/%.2f/%.2f",
+            p == 0 ? "" : " | ",
+            phaseNames[p],
+            this->percentile((Phase)p, 50.0) * 1000.0,
+            this->percentile((Phase)p, 95.0) * 1000.0,
+            this->percentile((Phase)p, 99.0) * 1000.0);
+        result += line;
+    }
+
+    return result + " ms (p50/p95/p99)";
+}
+
+bool FrameStats::openCsv(const char* path)
+{
+    this->csv = fopen(path, "w");
+    if (!this->csv) return false;
+
+    fprintf(this->csv, "frame,simulate,rebuild,draw,swap\n");
+    return true;
+}
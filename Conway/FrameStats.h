@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//Per-frame timing of the main loop phases, kept in a rolling window so we can
+//report p50/p95/p99 instead of a jittery instantaneous number. The readout
+//goes to the window title and the console (we have no text renderer), and
+//optionally to a CSV file, one row per frame, for offline comparison runs.
+class FrameStats
+{
+public:
+
+    enum Phase
+    {
+        Simulate,   //sim.update() calls since the last rendered frame
+        Rebuild,    //translation rebuild / delta patching
+        Draw,       //draw calls
+        Swap,       //glfwSwapBuffers (includes waiting on vsync)
+        PhaseCount
+    };
+
+private:
+
+    //~4 seconds of history at 60 fps.
+    static const int historySize = 240;
+
+    double samples[PhaseCount][historySize] = {};
+    int head = 0;
+    int count = 0;
+    std::uint64_t frame = 0;
+
+    FILE* csv = nullptr;
+
+    //Scratch buffer for the percentile sort, reused between calls.
+    mutable std::vector<double> sorted;
+
+public:
+
+    ~FrameStats();
+
+    //Appends one frame worth of phase timings (seconds).
+    void addFrame(const double seconds[PhaseCount]);
+
+    //p in [0, 100], over the frames currently in the window.
+    double percentile(Phase phase, double p) const;
+
+    //One-line summary of all phases, milliseconds.
+    std::string summary() const;
+
+    //Every frame from here on is also appended to this CSV file.
+    bool openCsv(const char* path);
+};
@@ -0,0 +1,349 @@
+#include "HashLife.h"
+
+#include "Simulation.h"
+
+//Node ids 0 and 1 are the two leaves (dead and live cell); they are created
+//in the constructor so every other node can refer to them.
+
+HashLife::HashLife(int boardSize)
+    : boardSize(boardSize)
+{
+    Node dead;
+    dead.level = 0;
+    dead.nw = dead.ne = dead.sw = dead.se = -1;
+    dead.population = 0;
+    this->nodes.push_back(dead);
+
+    Node live = dead;
+    live.population = 1;
+    this->nodes.push_back(live);
+
+    //Smallest centered universe the whole board fits into (level 3 minimum so
+    //the padding check below always has sub-sub quadrants to look at).
+    int level = 3;
+    while ((1 << (level - 1)) < boardSize) level++;
+    this->root = this->emptyNode(level);
+}
+
+int HashLife::makeNode(int nw, int ne, int sw, int se)
+{
+    NodeKey key;
+    key.level = this->nodes[nw].level + 1;
+    key.nw = nw;
+    key.ne = ne;
+    key.sw = sw;
+    key.se = se;
+
+    auto it = this->canonical.find(key);
+    if (it != this->canonical.end()) return it->second;
+
+    Node node;
+    node.level = key.level;
+    node.nw = nw;
+    node.ne = ne;
+    node.sw = sw;
+    node.se = se;
+    node.population = this->nodes[nw].population + this->nodes[ne].population
+                    + this->nodes[sw].population + this->nodes[se].population;
+
+    int id = (int)this->nodes.size();
+    this->nodes.push_back(node);
+    this->canonical[key] = id;
+    return id;
+}
+
+int HashLife::emptyNode(int level)
+{
+    if (level == 0) return 0;
+    int child = this->emptyNode(level - 1);
+    return this->makeNode(child, child, child, child);
+}
+
+//Coordinates are centered: a level-L node spans [-2^(L-1), 2^(L-1)) in both
+//axes, x growing east and y growing south.
+int HashLife::setCellNode(int id, std::int64_t x, std::int64_t y, bool alive)
+{
+    const Node node = this->nodes[id];
+
+    if (node.level == 0) return alive ? 1 : 0;
+
+    int nw = node.nw, ne = node.ne, sw = node.sw, se = node.se;
+
+    if (node.level == 1)
+    {
+        if (y < 0) { if (x < 0) nw = alive ? 1 : 0; else ne = alive ? 1 : 0; }
+        else       { if (x < 0) sw = alive ? 1 : 0; else se = alive ? 1 : 0; }
+        return this->makeNode(nw, ne, sw, se);
+    }
+
+    std::int64_t quarter = (std::int64_t)1 << (node.level - 2);
+    if (y < 0)
+    {
+        if (x < 0) nw = this->setCellNode(nw, x + quarter, y + quarter, alive);
+        else       ne = this->setCellNode(ne, x - quarter, y + quarter, alive);
+    }
+    else
+    {
+        if (x < 0) sw = this->setCellNode(sw, x + quarter, y - quarter, alive);
+        else       se = this->setCellNode(se, x - quarter, y - quarter, alive);
+    }
+    return this->makeNode(nw, ne, sw, se);
+}
+
+bool HashLife::getCellNode(int id, std::int64_t x, std::int64_t y) const
+{
+    const Node& node = this->nodes[id];
+
+    if (node.level == 0) return id == 1;
+
+    if (node.level == 1)
+    {
+        if (y < 0) return (x < 0 ? node.nw : node.ne) == 1;
+        return (x < 0 ? node.sw : node.se) == 1;
+    }
+
+    std::int64_t quarter = (std::int64_t)1 << (node.level - 2);
+    if (y < 0)
+    {
+        if (x < 0) return this->getCellNode(node.nw, x + quarter, y + quarter);
+        return this->getCellNode(node.ne, x - quarter, y + quarter);
+    }
+    if (x < 0) return this->getCellNode(node.sw, x + quarter, y - quarter);
+    return this->getCellNode(node.se, x - quarter, y - quarter);
+}
+
+//Base case: a 4x4 node advanced one generation into its 2x2 centre.
+int HashLife::life4x4(int id)
+{
+    bool cell[4][4];
+    for (int y = -2; y < 2; y++)
+    {
+        for (int x = -2; x < 2; x++)
+        {
+            cell[y + 2][x + 2] = this->getCellNode(id, x, y);
+        }
+    }
+
+    int result[2][2];
+    for (int y = 1; y <= 2; y++)
+    {
+        for (int x = 1; x <= 2; x++)
+        {
+            int aliveNeighbours = 0;
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    if (dx == 0 && dy == 0) continue;
+                    if (cell[y + dy][x + dx]) aliveNeighbours++;
+                }
+            }
+            bool alive = cell[y][x];
+            result[y - 1][x - 1] = (aliveNeighbours == 3 || (alive && aliveNeighbours == 2)) ? 1 : 0;
+        }
+    }
+
+    return this->makeNode(result[0][0], result[0][1], result[1][0], result[1][1]);
+}
+
+int HashLife::centeredSubnode(int id)
+{
+    const Node& n = this->nodes[id];
+    return this->makeNode(this->nodes[n.nw].se, this->nodes[n.ne].sw,
+                          this->nodes[n.sw].ne, this->nodes[n.se].nw);
+}
+
+int HashLife::centeredHorizontal(int west, int east)
+{
+    const Node& w = this->nodes[west];
+    const Node& e = this->nodes[east];
+    return this->makeNode(this->nodes[w.ne].se, this->nodes[e.nw].sw,
+                          this->nodes[w.se].ne, this->nodes[e.sw].nw);
+}
+
+int HashLife::centeredVertical(int north, int south)
+{
+    const Node& n = this->nodes[north];
+    const Node& s = this->nodes[south];
+    return this->makeNode(this->nodes[n.sw].se, this->nodes[n.se].sw,
+                          this->nodes[s.nw].ne, this->nodes[s.ne].nw);
+}
+
+int HashLife::centeredSubSubnode(int id)
+{
+    const Node& n = this->nodes[id];
+    return this->makeNode(this->nodes[this->nodes[n.nw].se].se,
+                          this->nodes[this->nodes[n.ne].sw].sw,
+                          this->nodes[this->nodes[n.sw].ne].ne,
+                          this->nodes[this->nodes[n.se].nw].nw);
+}
+
+//Returns the centre of id (one level down) advanced by
+//2^min(cap, level - 2) generations. Memoized — this cache is the whole
+//point of Hashlife.
+int HashLife::advance(int id, int cap)
+{
+    //Copy, not reference: makeNode can grow the vector under us.
+    const Node n = this->nodes[id];
+
+    if (n.population == 0) return this->emptyNode(n.level - 1);
+
+    int capEff = cap < n.level - 2 ? cap : n.level - 2;
+    std::uint64_t key = (std::uint64_t)id * 64 + capEff;
+    auto it = this->results.find(key);
+    if (it != this->results.end()) return it->second;
+
+    int result;
+
+    if (n.level == 2)
+    {
+        result = this->life4x4(id);
+    }
+    else if (capEff < n.level - 2)
+    {
+        //Not enough time budget for full speed: the first layer stands
+        //still (centered subnodes), only the second layer advances.
+        int n00 = this->centeredSubnode(n.nw);
+        int n01 = this->centeredHorizontal(n.nw, n.ne);
+        int n02 = this->centeredSubnode(n.ne);
+        int n10 = this->centeredVertical(n.nw, n.sw);
+        int n11 = this->centeredSubSubnode(id);
+        int n12 = this->centeredVertical(n.ne, n.se);
+        int n20 = this->centeredSubnode(n.sw);
+        int n21 = this->centeredHorizontal(n.sw, n.se);
+        int n22 = this->centeredSubnode(n.se);
+
+        result = this->makeNode(
+            this->advance(this->makeNode(n00, n01, n10, n11), cap),
+            this->advance(this->makeNode(n01, n02, n11, n12), cap),
+            this->advance(this->makeNode(n10, n11, n20, n21), cap),
+            this->advance(this->makeNode(n11, n12, n21, n22), cap));
+    }
+    else
+    {
+        //Full speed: both layers advance 2^(level-3), together 2^(level-2).
+        const Node nw = this->nodes[n.nw];
+        const Node ne = this->nodes[n.ne];
+        const Node sw = this->nodes[n.sw];
+        const Node se = this->nodes[n.se];
+
+        int n00 = this->advance(n.nw, cap);
+        int n01 = this->advance(this->makeNode(nw.ne, ne.nw, nw.se, ne.sw), cap);
+        int n02 = this->advance(n.ne, cap);
+        int n10 = this->advance(this->makeNode(nw.sw, nw.se, sw.nw, sw.ne), cap);
+        int n11 = this->advance(this->makeNode(nw.se, ne.sw, sw.ne, se.nw), cap);
+        int n12 = this->advance(this->makeNode(ne.sw, ne.se, se.nw, se.ne), cap);
+        int n20 = this->advance(n.sw, cap);
+        int n21 = this->advance(this->makeNode(sw.ne, se.nw, sw.se, se.sw), cap);
+        int n22 = this->advance(n.se, cap);
+
+        result = this->makeNode(
+            this->advance(this->makeNode(n00, n01, n10, n11), cap),
+            this->advance(this->makeNode(n01, n02, n11, n12), cap),
+            this->advance(this->makeNode(n10, n11, n20, n21), cap),
+            this->advance(this->makeNode(n11, n12, n21, n22), cap));
+    }
+
+    this->results[key] = result;
+    return result;
+}
+
+//Re-centers the root inside a universe twice the size.
+void HashLife::expand()
+{
+    const Node n = this->nodes[this->root];
+    int e = this->emptyNode(n.level - 1);
+
+    this->root = this->makeNode(
+        this->makeNode(e, e, e, n.nw),
+        this->makeNode(e, e, n.ne, e),
+        this->makeNode(e, n.sw, e, e),
+        this->makeNode(n.se, e, e, e));
+}
+
+//True when all population sits in the central quarter, i.e. there is enough
+//empty margin that one full-speed advance cannot push cells past the edge.
+bool HashLife::isPadded() const
+{
+    const Node& n = this->nodes[this->root];
+    if (n.level < 3) return false;
+
+    const Node& nw = this->nodes[n.nw];
+    const Node& ne = this->nodes[n.ne];
+    const Node& sw = this->nodes[n.sw];
+    const Node& se = this->nodes[n.se];
+
+    return nw.population == this->nodes[this->nodes[nw.se].se].population
+        && ne.population == this->nodes[this->nodes[ne.sw].sw].population
+        && sw.population == this->nodes[this->nodes[sw.ne].ne].population
+        && se.population == this->nodes[this->nodes[se.nw].nw].population;
+}
+
+void HashLife::loadFrom(const Simulation& sim)
+{
+    for (int i = 0; i < this->boardSize; i++)
+    {
+        for (int j = 0; j < this->boardSize; j++)
+        {
+            if (!sim.isAlive(i, j)) continue;
+
+            std::int64_t x = j - this->boardSize / 2;
+            std::int64_t y = i - this->boardSize / 2;
+            this->root = this->setCellNode(this->root, x, y, true);
+        }
+    }
+}
+
+void HashLife::gather(int id, std::int64_t x0, std::int64_t y0, Simulation& sim) const
+{
+    const Node& node = this->nodes[id];
+    if (node.population == 0) return;
+
+    if (node.level == 0)
+    {
+        std::int64_t col = x0 + this->boardSize / 2;
+        std::int64_t row = y0 + this->boardSize / 2;
+        if (col < 0 || col >= this->boardSize || row < 0 || row >= this->boardSize) return;
+        sim.setAlive((int)row, (int)col, true);
+        return;
+    }
+
+    std::int64_t half = (std::int64_t)1 << (node.level - 1);
+    this->gather(node.nw, x0, y0, sim);
+    this->gather(node.ne, x0 + half, y0, sim);
+    this->gather(node.sw, x0, y0 + half, sim);
+    this->gather(node.se, x0 + half, y0 + half, sim);
+}
+
+void HashLife::writeTo(Simulation& sim) const
+{
+    for (int i = 0; i < this->boardSize; i++)
+    {
+        for (int j = 0; j < this->boardSize; j++)
+        {
+            if (sim.isAlive(i, j)) sim.setAlive(i, j, false);
+        }
+    }
+
+    std::int64_t half = (std::int64_t)1 << (this->nodes[this->root].level - 1);
+    this->gather(this->root, -half, -half, sim);
+}
+
+void HashLife::run(std::uint64_t generations)
+{
+    while (generations > 0)
+    {
+        //Largest power of two not above what is left.
+        int cap = 0;
+        while (((std::uint64_t)2 << cap) <= generations) cap++;
+
+        while (!this->isPadded() || this->nodes[this->root].level - 2 < cap)
+        {
+            this->expand();
+        }
+
+        this->root = this->advance(this->root, cap);
+        this->generation += (std::uint64_t)1 << cap;
+        generations -= (std::uint64_t)1 << cap;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Simulation;
+
+//Hashlife: the board is a quadtree of canonicalized nodes (every distinct
+//subtree exists exactly once) and the result of advancing a node's centre by
+//2^(level-2) generations is memoized, so repetitive patterns fast-forward
+//through billions of generations in logarithmic work. Note that Hashlife
+//simulates an unbounded plane, while the array engine has hard walls; results
+//only match while the pattern stays away from the board edge.
+class HashLife
+{
+    struct Node
+    {
+        int level;
+        int nw, ne, sw, se;
+        std::uint64_t population;
+    };
+
+    struct NodeKey
+    {
+        int level;
+        int nw, ne, sw, se;
+
+        bool operator==(const NodeKey& other) const
+        {
+            return level == other.level && nw == other.nw && ne == other.ne
+                && sw == other.sw && se == other.se;
+        }
+    };
+
+    struct NodeKeyHash
+    {
+        size_t operator()(const NodeKey& key) const
+        {
+            std::uint64_t h = (std::uint64_t)key.level;
+            h = h * 0x9E3779B97F4A7C15ull + (std::uint64_t)key.nw;
+            h = h * 0x9E3779B97F4A7C15ull + (std::uint64_t)key.ne;
+            h = h * 0x9E3779B97F4A7C15ull + (std::uint64_t)key.sw;
+            h = h * 0x9E3779B97F4A7C15ull + (std::uint64_t)key.se;
+            return (size_t)(h ^ (h >> 32));
+        }
+    };
+
+    int boardSize;
+    std::vector<Node> nodes;
+    std::unordered_map<NodeKey, int, NodeKeyHash> canonical;
+
+    //advance result per (node, capped exponent); key is id * 64 + cap.
+    std::unordered_map<std::uint64_t, int> results;
+
+    int root = 0;
+    std::uint64_t generation = 0;
+
+    int makeNode(int nw, int ne, int sw, int se);
+    int emptyNode(int level);
+    int setCellNode(int id, std::int64_t x, std::int64_t y, bool alive);
+    bool getCellNode(int id, std::int64_t x, std::int64_t y) const;
+    int life4x4(int id);
+    int centeredSubnode(int id);
+    int centeredHorizontal(int west, int east);
+    int centeredVertical(int north, int south);
+    int centeredSubSubnode(int id);
+    int advance(int id, int cap);
+    void expand();
+    bool isPadded() const;
+    void gather(int id, std::int64_t x0, std::int64_t y0, Simulation& sim) const;
+
+public:
+
+    explicit HashLife(int boardSize);
+
+    //Copies the live cells out of / back into the array engine. writeTo clips
+    //anything that drifted off the board.
+    void loadFrom(const Simulation& sim);
+    void writeTo(Simulation& sim) const;
+
+    //Fast-forwards the given number of generations, consumed in power-of-two
+    //chunks through the memoized recursion.
+    void run(std::uint64_t generations);
+
+    std::uint64_t getGeneration() const { return this->generation; }
+    std::uint64_t getPopulation() const { return this->nodes[this->root].population; }
+};
@@ -0,0 +1,193 @@
+#include "History.h"
+
+#include "Simulation.h"
+
+History::History(int capacity)
+{
+    if (capacity < 1) capacity = 1;
+    this->ring.resize(capacity);
+}
+
+//Bit-packs the board into out, 64 cells per word, row-major.
+void History::pack(const Simulation& sim, std::vector<std::uint64_t>& out)
+{
+    sim.copyCellsTo(this->cellScratch);
+
+    out.assign(this->words, 0);
+    for (size_t n = 0; n < this->cellScratch.size(); n++)
+    {
+        if (this->cellScratch[n]) out[n / 64] |= 1ull << (n % 64);
+    }
+}
+
+void History::record(const Simulation& sim)
+{
+    if (this->packedPrev.empty())
+    {
+        //First record: just the baseline, there is nothing to diff against.
+        this->size = sim.getSize();
+        this->words = ((size_t)this->size * this->size + 63) / 64;
+        this->pack(sim, this->packedPrev);
+        this->prevGeneration = sim.getGeneration();
+        return;
+    }
+
+    this->pack(sim, this->packedScratch);
+
+    Delta& delta = this->ring[this->head];
+    delta.fromGeneration = this->prevGeneration;
+    delta.changedWords.clear();
+
+    for (size_t w = 0; w < this->words; w++)
+    {
+        std::uint64_t diff = this->packedScratch[w] ^ this->packedPrev[w];
+        if (diff) delta.changedWords.push_back({ (std::uint32_t)w, diff });
+    }
+
+    this->head = (this->head + 1) % this->ring.size();
+    if (this->count < this->ring.size()) this->count++;
+
+    std::swap(this->packedPrev, this->packedScratch);
+    this->prevGeneration = sim.getGeneration();
+}
+
+bool History::stepBack(Simulation& sim)
+{
+    //Rewinding from the newest slot would walk into the banked future, not
+    //the past; drop it first (a no-op when nothing is banked).
+    this->discardSpeculation();
+
+    if (this->count == 0) return false;
+
+    this->head = (this->head + this->ring.size() - 1) % this->ring.size();
+    this->count--;
+
+    const Delta& delta = this->ring[this->head];
+
+    //XOR is its own inverse: applying the delta to the last recorded state
+    //turns it back into the one before it.
+    for (size_t n = 0; n < delta.changedWords.size(); n++)
+    {
+        this->packedPrev[delta.changedWords[n].first] ^= delta.changedWords[n].second;
+    }
+
+    //Sync the simulation to the restored state. Comparing packed words first
+    //means untouched stretches of the board cost one compare per 64 cells;
+    //this also repairs any edits made since the record.
+    this->pack(sim, this->packedScratch);
+    for (size_t w = 0; w < this->words; w++)
+    {
+        std::uint64_t diff = this->packedScratch[w] ^ this->packedPrev[w];
+        while (diff)
+        {
+            int bit = 0;
+            while (!((diff >> bit) & 1)) bit++;
+            diff &= diff - 1;
+
+            size_t cell = w * 64 + bit;
+            int row = (int)(cell / this->size);
+            int col = (int)(cell % this->size);
+            sim.setAlive(row, col, (this->packedPrev[w] >> bit) & 1);
+        }
+    }
+
+    sim.setGeneration(delta.fromGeneration);
+    this->prevGeneration = delta.fromGeneration;
+    return true;
+}
+
+void History::recordEdits(const Simulation& sim)
+{
+    if (this->packedPrev.empty())
+    {
+        this->record(sim);
+        return;
+    }
+
+    this->pack(sim, this->packedScratch);
+    for (size_t w = 0; w < this->words; w++)
+    {
+        if (this->packedScratch[w] != this->packedPrev[w])
+        {
+            this->record(sim);
+            return;
+        }
+    }
+}
+
+void History::recordSpeculative(const Simulation& spec)
+{
+    //Never let the bank wrap onto itself; the simulation thread caps well
+    //below this anyway so rewind depth survives.
+    if (this->future + 1 >= this->ring.size()) return;
+
+    if (this->future == 0)
+    {
+        this->packedLive = this->packedPrev;
+        this->liveGeneration = this->prevGeneration;
+    }
+
+    //From here it is an ordinary record: the deltas chain off the speculated
+    //states exactly like they chain off simulated ones.
+    this->record(spec);
+    this->future++;
+}
+
+bool History::stepForward(Simulation& sim)
+{
+    if (this->future == 0) return false;
+
+    //The oldest banked delta sits `future` slots behind the head.
+    const Delta& delta = this->ring[(this->head + this->ring.size() - this->future) % this->ring.size()];
+    this->future--;
+
+    for (size_t n = 0; n < delta.changedWords.size(); n++)
+    {
+        std::uint32_t w = delta.changedWords[n].first;
+        std::uint64_t mask = delta.changedWords[n].second;
+        this->packedLive[w] ^= mask;
+
+        //Only the flipped cells are written; setAlive keeps the population
+        //and the dirty set honest, same as stepBack.
+        while (mask)
+        {
+            int bit = 0;
+            while (!((mask >> bit) & 1)) bit++;
+            mask &= mask - 1;
+
+            size_t cell = (size_t)w * 64 + bit;
+            int row = (int)(cell / this->size);
+            int col = (int)(cell % this->size);
+            sim.setAlive(row, col, (this->packedLive[w] >> bit) & 1);
+        }
+    }
+
+    //The generation we landed on is where the next banked delta starts from
+    //(or, when the bank just ran dry, the newest record).
+    std::uint64_t landed = this->future > 0
+        ? this->ring[(this->head + this->ring.size() - this->future) % this->ring.size()].fromGeneration
+        : this->prevGeneration;
+    sim.setGeneration(landed);
+    this->liveGeneration = landed;
+    return true;
+}
+
+void History::discardSpeculation()
+{
+    if (this->future == 0) return;
+
+    this->head = (this->head + this->ring.size() - this->future) % this->ring.size();
+    this->count -= this->future;
+    this->future = 0;
+
+    std::swap(this->packedPrev, this->packedLive);
+    this->prevGeneration = this->liveGeneration;
+}
+
+void History::clear()
+{
+    this->packedPrev.clear();
+    this->head = 0;
+    this->count = 0;
+    this->future = 0;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class Simulation;
+
+//Rewind history. Every recorded generation is stored as the XOR of its
+//bit-packed rows against the previous record, kept as sparse (word index,
+//xor mask) pairs - so memory scales with how many cells changed, not with
+//the board. The deltas sit in a fixed-size ring and stepping backward just
+//applies the newest one in reverse: no re-simulation, no snapshot files.
+class History
+{
+    int size = 0;           //board size the packed words describe
+    size_t words = 0;       //packed words per board
+
+    //Bit-packed copy of the last recorded generation; deltas XOR against it.
+    std::vector<std::uint64_t> packedPrev;
+    std::vector<std::uint64_t> packedScratch;
+    std::vector<std::uint8_t> cellScratch;
+
+    //One recorded step: the generation number of the state it came FROM
+    //(what a rewind lands on - fast-forwards can jump more than one) and the
+    //packed words that changed getting away from it.
+    struct Delta
+    {
+        std::uint64_t fromGeneration = 0;
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> changedWords;
+    };
+
+    std::vector<Delta> ring;
+    size_t head = 0;        //next slot to write
+    size_t count = 0;       //deltas available to rewind through
+
+    //Generation number of the last recorded state.
+    std::uint64_t prevGeneration = 0;
+
+    //Run-ahead speculation: the newest `future` deltas in the ring describe
+    //generations the board has not reached yet (banked by the simulation
+    //thread while paused). packedLive / liveGeneration pin where the board
+    //actually is, so the bank can be played back or thrown away.
+    size_t future = 0;
+    std::vector<std::uint64_t> packedLive;
+    std::uint64_t liveGeneration = 0;
+
+    void pack(const Simulation& sim, std::vector<std::uint64_t>& out);
+
+public:
+
+    History(int capacity);
+
+    //Records the simulation's current board. The first call just takes the
+    //baseline; every later call stores a delta against the previous record,
+    //dropping the oldest one once the ring is full.
+    void record(const Simulation& sim);
+
+    //Restores the board to the generation before the newest recorded one.
+    //Returns false when the ring has nothing left to rewind into.
+    bool stepBack(Simulation& sim);
+
+    //Records a delta for any edits made since the last record (the
+    //generation number doesn't move); a no-op when the board still matches.
+    //Run before banking so the speculated chain starts from the board as it
+    //actually is - and R then undoes the edit like any other step.
+    void recordEdits(const Simulation& sim);
+
+    //Banks one speculated generation: like record(), but the live board is
+    //pinned first so the delta counts as future, not past.
+    void recordSpeculative(const Simulation& spec);
+
+    //Advances the board along the oldest banked delta - only the cells the
+    //delta flips are touched, so a replayed generation costs its activity,
+    //not a simulation pass. The board must not have been edited since the
+    //bank was recorded (edits go through discardSpeculation). Returns false
+    //when nothing is banked.
+    bool stepForward(Simulation& sim);
+
+    //Throws the banked future away; the ring and packed state roll back to
+    //the live board. Called before any edit while speculation is running.
+    void discardSpeculation();
+
+    size_t getFutureCount() const { return this->future; }
+    size_t getCapacity() const { return this->ring.size(); }
+
+    //Generations currently available to rewind through.
+    size_t getDepth() const { return this->count - this->future; }
+
+    //Forgets everything; the next record() takes a fresh baseline. Used when
+    //a snapshot load replaces the board wholesale.
+    void clear();
+};
@@ -0,0 +1,106 @@
+#include "RleLoader.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "Simulation.h"
+
+bool loadRlePattern(const char* path, Simulation& sim)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    //The one allocation: the raw file, decoded in place below.
+    std::vector<char> data((size_t)length + 1);
+    size_t read = fread(&data[0], 1, (size_t)length, file);
+    fclose(file);
+    data[read] = '\0';
+
+    return loadRleString(&data[0], sim);
+}
+
+bool loadRleString(const char* text, Simulation& sim)
+{
+    const char* p = text;
+
+    //Comment lines (#...) come first, then the header: x = W, y = H [, rule = ...]
+    while (*p == '#')
+    {
+        while (*p && *p != '\n') p++;
+        if (*p) p++;
+    }
+
+    long width = 0, height = 0;
+    if (*p != 'x') return false;
+    while (*p && *p != '=') p++;
+    if (!*p) return false;
+    p++;
+    while (*p == ' ') p++;
+    while (*p >= '0' && *p <= '9') width = width * 10 + (*p++ - '0');
+    while (*p && *p != 'y') p++;
+    if (!*p) return false;
+    while (*p && *p != '=') p++;
+    if (!*p) return false;
+    p++;
+    while (*p == ' ') p++;
+    while (*p >= '0' && *p <= '9') height = height * 10 + (*p++ - '0');
+    while (*p && *p != '\n') p++;
+
+    if (width <= 0 || height <= 0) return false;
+
+    //Center the pattern; cells falling off the board are clipped.
+    int size = sim.getSize();
+    long startRow = (size - height) / 2;
+    long startCol = (size - width) / 2;
+
+    long row = 0;
+    long col = 0;
+    long runCount = 0;
+
+    for (; *p; p++)
+    {
+        char c = *p;
+
+        if (c >= '0' && c <= '9')
+        {
+            runCount = runCount * 10 + (c - '0');
+        }
+        else if (c == '$')
+        {
+            row += runCount == 0 ? 1 : runCount;
+            col = 0;
+            runCount = 0;
+        }
+        else if (c == '!')
+        {
+            return true;
+        }
+        else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+        {
+            //'b' is a dead run, every other tag counts as alive.
+            long run = runCount == 0 ? 1 : runCount;
+            if (c != 'b' && c != 'B')
+            {
+                for (long n = 0; n < run; n++)
+                {
+                    long r = startRow + row;
+                    long cl = startCol + col + n;
+                    if (r >= 0 && r < size && cl >= 0 && cl < size)
+                    {
+                        sim.setAlive((int)r, (int)cl, true);
+                    }
+                }
+            }
+            col += run;
+            runCount = 0;
+        }
+        //whitespace and newlines inside the data are simply skipped
+    }
+
+    //Missing the closing '!' but everything parsed; accept it.
+    return true;
+}
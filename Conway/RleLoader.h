@@ -0,0 +1,14 @@
+#pragma once
+
+class Simulation;
+
+//Loads a pattern in the standard Golly RLE format and stamps it into the
+//middle of the board (clipped if it doesn't fit). Single pass over the raw
+//file bytes with no tokenizing or per-cell allocations, so multi-megabyte
+//patterns load in milliseconds. Returns false if the file can't be read or
+//isn't valid RLE.
+bool loadRlePattern(const char* path, Simulation& sim);
+
+//Same parser over an in-memory RLE string; the benchmark suite embeds its
+//pattern corpus directly in the binary.
+bool loadRleString(const char* text, Simulation& sim);
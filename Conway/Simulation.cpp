@@ -0,0 +1,562 @@
+#include "Simulation.h"
+
+#include <bitset>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//CPUID feature checks, done once at startup.
+static bool cpuHasAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static bool cpuHasSse2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+Simulation::Simulation(int size)
+    : size(size)
+    , stride(size + 2)
+    , cells((size_t)(size + 2) * (size + 2), 0)
+    , next((size_t)(size + 2) * (size + 2), 0)
+{
+}
+
+Simulation::~Simulation()
+{
+    this->stopWorkers();
+}
+
+void Simulation::stopWorkers()
+{
+    if (this->workers.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(this->poolMutex);
+        this->poolQuitting = true;
+    }
+    this->poolWake.notify_all();
+
+    for (size_t i = 0; i < this->workers.size(); i++)
+    {
+        this->workers[i].join();
+    }
+
+    this->workers.clear();
+    this->poolQuitting = false;
+}
+
+void Simulation::setThreadCount(int threads)
+{
+    if (threads < 1) threads = 1;
+    if (threads == this->threadCount) return;
+
+    this->stopWorkers();
+    this->threadCount = threads;
+
+    if (threads == 1) return;
+
+    for (int i = 0; i < threads; i++)
+    {
+        this->workers.push_back(std::thread(&Simulation::workerLoop, this, i));
+    }
+}
+
+void Simulation::workerLoop(int workerIndex)
+{
+    std::uint64_t lastJob = 0;
+
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(this->poolMutex);
+        this->poolWake.wait(lock, [&] { return this->poolQuitting || this->poolJob != lastJob; });
+        if (this->poolQuitting) return;
+        lastJob = this->poolJob;
+        lock.unlock();
+
+        int bandHeight = (this->size + this->threadCount - 1) / this->threadCount;
+        int rowBegin = workerIndex * bandHeight;
+        int rowEnd = rowBegin + bandHeight;
+        if (rowEnd > this->size) rowEnd = this->size;
+
+        CellTally bandTally;
+        if (rowBegin < rowEnd) this->computeRows(rowBegin, rowEnd, bandTally);
+
+        lock.lock();
+        this->jobTally.population += bandTally.population;
+        this->jobTally.births += bandTally.births;
+        this->jobTally.deaths += bandTally.deaths;
+        this->bandsRemaining--;
+        if (this->bandsRemaining == 0) this->poolDone.notify_one();
+    }
+}
+
+void Simulation::clear()
+{
+    if (this->incremental)
+    {
+        //Record the deaths so delta consumers (renderer) stay in sync.
+        for (int i = 0; i < this->size; i++)
+        {
+            for (int j = 0; j < this->size; j++)
+            {
+                if (this->isAlive(i, j)) this->changedCells.push_back(i * this->size + j);
+            }
+        }
+    }
+
+    std::fill(this->cells.begin(), this->cells.end(), 0);
+    this->bits.clear();
+    this->population = 0;
+}
+
+Kernel Simulation::detectKernel()
+{
+    if (cpuHasAvx2() || cpuHasSse2()) return Kernel::Simd;
+    return Kernel::Scalar;
+}
+
+void Simulation::setKernel(Kernel kernel)
+{
+    if (kernel == this->kernel) return;
+
+    if (kernel == Kernel::Bitwise)
+    {
+        //Pack the byte grid into bits; the byte buffers stay allocated but
+        //stale until we switch back.
+        this->bits = BitGrid(this->size);
+        this->bitsNext = BitGrid(this->size);
+        for (int i = 0; i < this->size; i++)
+        {
+            for (int j = 0; j < this->size; j++)
+            {
+                if (this->cells[this->cellIndex(i, j)]) this->bits.set(i, j, true);
+            }
+        }
+    }
+    else if (this->kernel == Kernel::Bitwise)
+    {
+        //Scalar and Simd share the byte storage, only Bitwise needs unpacking.
+        for (int i = 0; i < this->size; i++)
+        {
+            for (int j = 0; j < this->size; j++)
+            {
+                this->cells[this->cellIndex(i, j)] = this->bits.get(i, j) ? 1 : 0;
+            }
+        }
+    }
+
+    this->kernel = kernel;
+}
+
+void Simulation::setIncremental(bool incremental)
+{
+    this->incremental = incremental;
+    if (!incremental) return;
+
+    this->candidateMark.assign((size_t)this->size * this->size, 0);
+
+    //Seed the active set with every live cell: a dead cell can only come to
+    //life next to a live one, so this covers everything that can change.
+    this->changedCells.clear();
+    for (int i = 0; i < this->size; i++)
+    {
+        for (int j = 0; j < this->size; j++)
+        {
+            if (this->isAlive(i, j)) this->changedCells.push_back(i * this->size + j);
+        }
+    }
+}
+
+int Simulation::countAliveNeighbours(int row, int col) const
+{
+    //The ghost border makes all 8 reads valid for every cell, so the old
+    //per-neighbour bounds checks are gone.
+    const std::uint8_t* above = &this->cells[this->cellIndex(row - 1, col)];
+    const std::uint8_t* curr  = &this->cells[this->cellIndex(row, col)];
+    const std::uint8_t* below = &this->cells[this->cellIndex(row + 1, col)];
+
+    return above[-1] + above[0] + above[1]
+         + curr[-1]            + curr[1]
+         + below[-1] + below[0] + below[1];
+}
+
+void Simulation::updateIncremental()
+{
+    //Gather the cells that changed last generation plus their neighbours,
+    //deduplicated through the mark buffer.
+    this->candidates.clear();
+    for (size_t n = 0; n < this->changedCells.size(); n++)
+    {
+        int row = this->changedCells[n] / this->size;
+        int col = this->changedCells[n] % this->size;
+
+        for (int x = -1; x <= 1; x++)
+        {
+            for (int y = -1; y <= 1; y++)
+            {
+                int r = row + x;
+                int c = col + y;
+
+                if (this->topology == Topology::Torus)
+                {
+                    //A changed edge cell wakes its neighbours on the far side.
+                    r = (r + this->size) % this->size;
+                    c = (c + this->size) % this->size;
+                }
+                else if (r < 0 || r >= this->size || c < 0 || c >= this->size)
+                {
+                    continue;
+                }
+
+                int idx = r * this->size + c;
+                if (!this->candidateMark[idx])
+                {
+                    this->candidateMark[idx] = 1;
+                    this->candidates.push_back(idx);
+                }
+            }
+        }
+    }
+
+    //Evaluate the candidates in place: first collect the flips (reads must
+    //see the old generation), then apply them.
+    this->changedCells.clear();
+    for (size_t n = 0; n < this->candidates.size(); n++)
+    {
+        int idx = this->candidates[n];
+        this->candidateMark[idx] = 0;
+
+        int aliveNeighbours = this->countAliveNeighbours(idx / this->size, idx % this->size);
+        bool alive = this->cells[this->cellIndex(idx / this->size, idx % this->size)] != 0;
+        bool aliveNext = aliveNeighbours == 3 || (alive && aliveNeighbours == 2);
+
+        if (alive != aliveNext) this->changedCells.push_back(idx);
+    }
+
+    //The flips are the births and deaths, no counting pass needed.
+    this->births = 0;
+    this->deaths = 0;
+    for (size_t n = 0; n < this->changedCells.size(); n++)
+    {
+        int idx = this->changedCells[n];
+        std::uint8_t& cell = this->cells[this->cellIndex(idx / this->size, idx % this->size)];
+        if (cell) this->deaths++;
+        else this->births++;
+        cell ^= 1;
+    }
+    this->population += this->births - this->deaths;
+}
+
+//After a full-scan generation the previous state sits in the back buffer, so
+//the changed set is rebuilt by diffing the two.
+void Simulation::rebuildChangedCells()
+{
+    this->changedCells.clear();
+    for (int i = 0; i < this->size; i++)
+    {
+        for (int j = 0; j < this->size; j++)
+        {
+            size_t idx = this->cellIndex(i, j);
+            if (this->cells[idx] != this->next[idx]) this->changedCells.push_back(i * this->size + j);
+        }
+    }
+}
+
+//Copies the opposite edges into the ghost border so the kernels wrap for
+//free. Under Walls the border was zeroed at allocation and nothing ever
+//writes it, so there is nothing to do per generation.
+void Simulation::syncHalo()
+{
+    std::uint8_t* grid = &this->cells[0];
+    int n = this->size;
+
+    //Ghost rows first, then the ghost columns pick the corners up from them.
+    std::memcpy(&grid[this->cellIndex(-1, 0)], &grid[this->cellIndex(n - 1, 0)], n);
+    std::memcpy(&grid[this->cellIndex(n, 0)], &grid[this->cellIndex(0, 0)], n);
+
+    for (int r = -1; r <= n; r++)
+    {
+        grid[this->cellIndex(r, -1)] = grid[this->cellIndex(r, n - 1)];
+        grid[this->cellIndex(r, n)] = grid[this->cellIndex(r, 0)];
+    }
+}
+
+void Simulation::update()
+{
+    if (this->kernel == Kernel::Bitwise) this->generation += this->fusedSteps;
+    else this->generation++;
+
+    if (this->topology == Topology::Torus && this->kernel != Kernel::Bitwise) this->syncHalo();
+
+    if (this->incremental && this->kernel != Kernel::Bitwise)
+    {
+        //Roughly 9 candidates per changed cell; once that approaches the
+        //board area the full-scan kernels are faster than chasing indices.
+        if (this->changedCells.size() * 9 < (size_t)this->size * this->size / 2)
+        {
+            this->updateIncremental();
+            return;
+        }
+    }
+
+    this->jobTally = CellTally();
+
+    if (this->threadCount > 1)
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->poolMutex);
+            this->bandsRemaining = this->threadCount;
+            this->poolJob++;
+        }
+        this->poolWake.notify_all();
+
+        std::unique_lock<std::mutex> lock(this->poolMutex);
+        this->poolDone.wait(lock, [&] { return this->bandsRemaining == 0; });
+    }
+    else
+    {
+        this->computeRows(0, this->size, this->jobTally);
+    }
+
+    this->population = this->jobTally.population;
+    this->births = this->jobTally.births;
+    this->deaths = this->jobTally.deaths;
+
+    //Swap the buffers instead of copying the whole grid back; every kernel
+    //writes every cell of its rows, so the stale back buffer never shows.
+    if (this->kernel == Kernel::Bitwise) std::swap(this->bits, this->bitsNext);
+    else std::swap(this->cells, this->next);
+
+    if (this->incremental && this->kernel != Kernel::Bitwise) this->rebuildChangedCells();
+}
+
+void Simulation::copyCellsTo(std::vector<std::uint8_t>& out) const
+{
+    out.resize((size_t)this->size * this->size);
+
+    if (this->kernel == Kernel::Bitwise)
+    {
+        for (int i = 0; i < this->size; i++)
+        {
+            for (int j = 0; j < this->size; j++)
+            {
+                out[(size_t)i * this->size + j] = this->bits.get(i, j) ? 1 : 0;
+            }
+        }
+    }
+    else
+    {
+        //The byte rows are contiguous apart from the ghost border.
+        for (int i = 0; i < this->size; i++)
+        {
+            std::memcpy(&out[(size_t)i * this->size], &this->cells[this->cellIndex(i, 0)], this->size);
+        }
+    }
+}
+
+void Simulation::copyCellsFrom(const std::vector<std::uint8_t>& in)
+{
+    for (int i = 0; i < this->size; i++)
+    {
+        for (int j = 0; j < this->size; j++)
+        {
+            bool alive = in[(size_t)i * this->size + j] != 0;
+            if (this->isAlive(i, j) != alive) this->setAlive(i, j, alive);
+        }
+    }
+}
+
+void Simulation::setRegion(int row, int col, int height, int width, bool alive)
+{
+    int rowEnd = row + height;
+    int colEnd = col + width;
+    if (row < 0) row = 0;
+    if (col < 0) col = 0;
+    if (rowEnd > this->size) rowEnd = this->size;
+    if (colEnd > this->size) colEnd = this->size;
+
+    for (int i = row; i < rowEnd; i++)
+    {
+        for (int j = col; j < colEnd; j++)
+        {
+            //setAlive is inline and only flips do any bookkeeping, so the
+            //pass costs what changed, not what was covered.
+            if (this->isAlive(i, j) != alive) this->setAlive(i, j, alive);
+        }
+    }
+}
+
+void Simulation::fillRegionRandom(int row, int col, int height, int width, int densityPercent, unsigned int seed)
+{
+    int rowEnd = row + height;
+    int colEnd = col + width;
+    if (row < 0) row = 0;
+    if (col < 0) col = 0;
+    if (rowEnd > this->size) rowEnd = this->size;
+    if (colEnd > this->size) colEnd = this->size;
+
+    srand(seed);
+    for (int i = row; i < rowEnd; i++)
+    {
+        for (int j = col; j < colEnd; j++)
+        {
+            bool alive = rand() % 100 < densityPercent;
+            if (this->isAlive(i, j) != alive) this->setAlive(i, j, alive);
+        }
+    }
+}
+
+//Computes rows [rowBegin, rowEnd) of the next generation with whatever kernel
+//is selected. Bands only read from the front buffer, so this is safe to call
+//from several workers at once as long as the ranges are disjoint.
+void Simulation::computeRows(int rowBegin, int rowEnd, CellTally& tally)
+{
+    if (this->kernel == Kernel::Bitwise)
+    {
+        if (this->fusedSteps > 1) this->bits.stepRowsFused(this->bitsNext, this->fusedSteps, rowBegin, rowEnd, tally);
+        else this->bits.stepRows(this->bitsNext, rowBegin, rowEnd, tally);
+    }
+    else if (this->kernel == Kernel::Simd) this->computeRowsSimd(rowBegin, rowEnd, tally);
+    else this->computeRowsScalar(rowBegin, rowEnd, tally);
+}
+
+//Computes the next state of row for columns [colBegin, colEnd). This is the
+//original loop; the SIMD kernel uses it for the tail of each row.
+void Simulation::computeCellsScalar(int row, int colBegin, int colEnd, CellTally& tally)
+{
+    int i = row;
+    for (int j = colBegin; j < colEnd; j++)
+    {
+        int aliveNeighbours = this->countAliveNeighbours(i, j);
+
+        std::uint8_t state;
+        if (this->isAlive(i, j) && (aliveNeighbours < 2 || aliveNeighbours > 3)) state = 0;
+        else if (!this->isAlive(i, j) && aliveNeighbours == 3) state = 1;
+        else
+        {
+            state = this->isAlive(i, j) ? 1 : 0;
+        }
+
+        std::uint8_t old = this->cells[this->cellIndex(i, j)];
+        tally.population += state;
+        tally.births += state & ~old & 1;
+        tally.deaths += old & ~state & 1;
+
+        this->next[this->cellIndex(i, j)] = state;
+    }
+}
+
+void Simulation::computeRowsScalar(int rowBegin, int rowEnd, CellTally& tally)
+{
+    for (int i = rowBegin; i < rowEnd; i++)
+    {
+        this->computeCellsScalar(i, 0, this->size, tally);
+    }
+}
+
+void Simulation::computeRowsSimd(int rowBegin, int rowEnd, CellTally& tally)
+{
+    static const bool avx2 = cpuHasAvx2();
+
+    if (this->size < 16)
+    {
+        //Too narrow for even one SSE2 block.
+        this->computeRowsScalar(rowBegin, rowEnd, tally);
+        return;
+    }
+
+    for (int i = rowBegin; i < rowEnd; i++)
+    {
+        //Thanks to the ghost border the unaligned loads at -1/+1 are valid
+        //for every row and every column, edge rows included.
+        const std::uint8_t* above = &this->cells[this->cellIndex(i - 1, 0)];
+        const std::uint8_t* curr  = &this->cells[this->cellIndex(i, 0)];
+        const std::uint8_t* below = &this->cells[this->cellIndex(i + 1, 0)];
+        std::uint8_t* dst = &this->next[this->cellIndex(i, 0)];
+
+        int j = 0;
+
+        //The 8 neighbour bytes of 32 (or 16) cells are summed with unaligned
+        //loads at offsets -1/0/+1 of the three rows, then the rule is applied
+        //with byte compares. Cells are 0/1 so the counts fit a byte with room
+        //to spare.
+        if (avx2)
+        {
+            for (; j + 32 <= this->size; j += 32)
+            {
+                __m256i count = _mm256_loadu_si256((const __m256i*)(above + j - 1));
+                count = _mm256_add_epi8(count, _mm256_loadu_si256((const __m256i*)(above + j)));
+                count = _mm256_add_epi8(count, _mm256_loadu_si256((const __m256i*)(above + j + 1)));
+                count = _mm256_add_epi8(count, _mm256_loadu_si256((const __m256i*)(curr + j - 1)));
+                count = _mm256_add_epi8(count, _mm256_loadu_si256((const __m256i*)(curr + j + 1)));
+                count = _mm256_add_epi8(count, _mm256_loadu_si256((const __m256i*)(below + j - 1)));
+                count = _mm256_add_epi8(count, _mm256_loadu_si256((const __m256i*)(below + j)));
+                count = _mm256_add_epi8(count, _mm256_loadu_si256((const __m256i*)(below + j + 1)));
+
+                __m256i cell = _mm256_loadu_si256((const __m256i*)(curr + j));
+                __m256i three = _mm256_cmpeq_epi8(count, _mm256_set1_epi8(3));
+                __m256i two   = _mm256_cmpeq_epi8(count, _mm256_set1_epi8(2));
+
+                //count == 3 births/keeps, count == 2 keeps a live cell
+                __m256i alive = _mm256_or_si256(three, _mm256_and_si256(two, _mm256_cmpeq_epi8(cell, _mm256_set1_epi8(1))));
+                _mm256_storeu_si256((__m256i*)(dst + j), _mm256_and_si256(alive, _mm256_set1_epi8(1)));
+
+                //Stats from the masks while the vectors are still around.
+                unsigned int newMask = (unsigned int)_mm256_movemask_epi8(alive);
+                unsigned int oldMask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(cell, _mm256_set1_epi8(1)));
+                tally.population += std::bitset<32>(newMask).count();
+                tally.births += std::bitset<32>(newMask & ~oldMask).count();
+                tally.deaths += std::bitset<32>(oldMask & ~newMask).count();
+            }
+        }
+
+        for (; j + 16 <= this->size; j += 16)
+        {
+            __m128i count = _mm_loadu_si128((const __m128i*)(above + j - 1));
+            count = _mm_add_epi8(count, _mm_loadu_si128((const __m128i*)(above + j)));
+            count = _mm_add_epi8(count, _mm_loadu_si128((const __m128i*)(above + j + 1)));
+            count = _mm_add_epi8(count, _mm_loadu_si128((const __m128i*)(curr + j - 1)));
+            count = _mm_add_epi8(count, _mm_loadu_si128((const __m128i*)(curr + j + 1)));
+            count = _mm_add_epi8(count, _mm_loadu_si128((const __m128i*)(below + j - 1)));
+            count = _mm_add_epi8(count, _mm_loadu_si128((const __m128i*)(below + j)));
+            count = _mm_add_epi8(count, _mm_loadu_si128((const __m128i*)(below + j + 1)));
+
+            __m128i cell = _mm_loadu_si128((const __m128i*)(curr + j));
+            __m128i three = _mm_cmpeq_epi8(count, _mm_set1_epi8(3));
+            __m128i two   = _mm_cmpeq_epi8(count, _mm_set1_epi8(2));
+
+            __m128i alive = _mm_or_si128(three, _mm_and_si128(two, _mm_cmpeq_epi8(cell, _mm_set1_epi8(1))));
+            _mm_storeu_si128((__m128i*)(dst + j), _mm_and_si128(alive, _mm_set1_epi8(1)));
+
+            unsigned int newMask = (unsigned int)_mm_movemask_epi8(alive);
+            unsigned int oldMask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(cell, _mm_set1_epi8(1)));
+            tally.population += std::bitset<32>(newMask).count();
+            tally.births += std::bitset<32>(newMask & ~oldMask).count();
+            tally.deaths += std::bitset<32>(oldMask & ~newMask).count();
+        }
+
+        this->computeCellsScalar(i, j, this->size, tally);
+    }
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BitGrid.h"
+
+//How the generation update is computed. Scalar is the original per-cell loop,
+//Simd does byte-wise neighbour adds 16/32 cells at a time (SSE2/AVX2), and
+//Bitwise runs on the bit-packed BitGrid representation.
+enum class Kernel
+{
+    Scalar,
+    Simd,
+    Bitwise
+};
+
+//Board topology. Walls is the original behaviour: cells past the edge are
+//simply dead. Torus wraps around, so gliders come back instead of dying at
+//the border. Both are implemented with the ghost border below, so neither
+//costs a single per-cell branch.
+enum class Topology
+{
+    Walls,
+    Torus
+};
+
+//Owns the world state and the generation update. The board is sized at runtime
+//and lives on the heap, so we are no longer tied to the compile-time
+//numberOfSeparators constant and can run (and benchmark) boards in the
+//4096x4096 range without blowing the stack.
+class Simulation
+{
+    int size;
+    int stride;
+
+    //The byte grid carries a one-cell ghost border: always dead under Walls,
+    //copies of the opposite edge under Torus (refreshed once per generation
+    //by syncHalo). The kernels read all 8 neighbours unconditionally, so the
+    //old per-cell edge checks are gone from every path.
+    std::vector<std::uint8_t> cells;
+    std::vector<std::uint8_t> next;
+
+    size_t cellIndex(int row, int col) const
+    {
+        return (size_t)(row + 1) * this->stride + (col + 1);
+    }
+
+    //Bit-packed representation, only valid while kernel == Kernel::Bitwise.
+    BitGrid bits;
+    BitGrid bitsNext;
+
+    Kernel kernel = Kernel::Scalar;
+    Topology topology = Topology::Walls;
+
+    //Bitwise only: generations advanced per update() in one fused pass.
+    int fusedSteps = 1;
+
+    //Refreshes the ghost border from the opposite edges (Torus only).
+    void syncHalo();
+
+    std::uint64_t generation = 0;
+
+    //Statistics of the board / of the last update(). The kernels tally them
+    //while writing their rows (see CellTally), so no extra scan is ever run;
+    //setAlive keeps the population honest across edits too.
+    std::uint64_t population = 0;
+    std::uint64_t births = 0;
+    std::uint64_t deaths = 0;
+
+    //Scratch tally for the current update; bands add theirs under poolMutex.
+    CellTally jobTally;
+
+    //Worker pool. Each generation the board is split into one horizontal band
+    //per thread; bands only read (never write) one row past their boundary,
+    //so the only synchronization is one wake-up and one join per generation.
+    int threadCount = 1;
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable poolWake;
+    std::condition_variable poolDone;
+    std::uint64_t poolJob = 0;
+    int bandsRemaining = 0;
+    bool poolQuitting = false;
+
+    void workerLoop(int workerIndex);
+    void stopWorkers();
+
+    void computeCellsScalar(int row, int colBegin, int colEnd, CellTally& tally);
+    void computeRowsScalar(int rowBegin, int rowEnd, CellTally& tally);
+    void computeRowsSimd(int rowBegin, int rowEnd, CellTally& tally);
+    void computeRows(int rowBegin, int rowEnd, CellTally& tally);
+
+    //Incremental mode: only the cells that changed last generation (and their
+    //8 neighbours) are re-evaluated, so sparse boards cost activity, not area.
+    bool incremental = false;
+    std::vector<int> changedCells;
+    std::vector<int> candidates;
+    std::vector<std::uint8_t> candidateMark;
+
+    int countAliveNeighbours(int row, int col) const;
+    void updateIncremental();
+    void rebuildChangedCells();
+
+public:
+
+    Simulation(int size);
+    ~Simulation();
+
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    //Picks the widest kernel this CPU supports (checked once via CPUID);
+    //falls back to the scalar loop on machines without SSE2.
+    static Kernel detectKernel();
+
+    int getSize() const { return this->size; }
+
+    //Generations advanced since construction (or since setGeneration, which
+    //snapshot restore uses to resume the count).
+    std::uint64_t getGeneration() const { return this->generation; }
+    void setGeneration(std::uint64_t generation) { this->generation = generation; }
+
+    //Maintained incrementally by the kernels and by setAlive; reading them
+    //never costs a pass over the grid.
+    std::uint64_t getPopulation() const { return this->population; }
+
+    //Cells born / died during the last update().
+    std::uint64_t getBirths() const { return this->births; }
+    std::uint64_t getDeaths() const { return this->deaths; }
+
+    //Kills every cell; the generation counter is left alone.
+    void clear();
+
+    Kernel getKernel() const { return this->kernel; }
+
+    //Switching kernels converts the storage, so it is cheap to do once at
+    //startup but not something to toggle every generation.
+    void setKernel(Kernel kernel);
+
+    Topology getTopology() const { return this->topology; }
+
+    //Ignored by the bitwise kernel, which steps the unpadded BitGrid and so
+    //always has hard walls.
+    void setTopology(Topology topology) { this->topology = topology; }
+
+    //Bitwise only: advance this many generations per update() in one pass
+    //over the grid (see BitGrid::stepRowsFused) instead of streaming the
+    //whole board through memory once per generation. getBirths/getDeaths then
+    //compare against the state from that many generations back, and the
+    //generation counter jumps by that much. Ignored by the other kernels; 1
+    //restores the single-step path.
+    void setFusedSteps(int steps) { this->fusedSteps = steps < 1 ? 1 : steps; }
+    int getFusedSteps() const { return this->fusedSteps; }
+
+    int getThreadCount() const { return this->threadCount; }
+
+    //1 keeps everything on the calling thread; more spins up a worker pool
+    //that splits each generation into that many row bands.
+    void setThreadCount(int threads);
+
+    //Re-evaluate only cells that changed last generation plus their
+    //neighbours, falling back to a full scan when too much of the board is
+    //active. Ignored by the bitwise kernel, which has no per-cell access.
+    void setIncremental(bool incremental);
+
+    bool isIncremental() const { return this->incremental; }
+
+    //The cells that flipped during the last update() (as row * size + col
+    //indices). Only maintained in incremental mode; consumers like the
+    //renderer use it to avoid rescanning the whole grid.
+    const std::vector<int>& getChangedCells() const { return this->changedCells; }
+
+    bool isAlive(int row, int col) const
+    {
+        if (this->kernel == Kernel::Bitwise) return this->bits.get(row, col);
+        return this->cells[this->cellIndex(row, col)] != 0;
+    }
+
+    void setAlive(int row, int col, bool alive)
+    {
+        bool wasAlive = this->isAlive(row, col);
+        if (this->kernel == Kernel::Bitwise) this->bits.set(row, col, alive);
+        else this->cells[this->cellIndex(row, col)] = alive ? 1 : 0;
+        if (alive && !wasAlive) this->population++;
+        else if (!alive && wasAlive) this->population--;
+        if (this->incremental) this->changedCells.push_back(row * this->size + col);
+    }
+
+    void toggle(int row, int col)
+    {
+        this->setAlive(row, col, !this->isAlive(row, col));
+    }
+
+    //Batched editing: writes an axis-aligned region in one clipped pass, so a
+    //brush stamp or rectangle fill is one call instead of one event per cell.
+    //Only cells that actually flip are counted and appended to the dirty set.
+    void setRegion(int row, int col, int height, int width, bool alive);
+
+    //Same pass, but every covered cell is redrawn alive at the given density
+    //(deterministic under the seed).
+    void fillRegionRandom(int row, int col, int height, int width, int densityPercent, unsigned int seed);
+
+    //Linear 0/1 copy of the board (row-major, without the ghost border), for
+    //handing a coherent snapshot of a generation to another thread.
+    void copyCellsTo(std::vector<std::uint8_t>& out) const;
+
+    //The inverse: overwrites the board from such a copy. Only cells that
+    //differ are written, so population and the dirty set stay right.
+    void copyCellsFrom(const std::vector<std::uint8_t>& in);
+
+    //Advances the world by one generation.
+    void update();
+};
@@ -0,0 +1,222 @@
+#include "Snapshot.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Simulation.h"
+
+//On-disk layout. Everything after the header is the grid, row by row,
+//64 cells per word, lowest bit first, with the last word of each row
+//zero-padded.
+struct SnapshotHeader
+{
+    char magic[4];
+    std::uint32_t size;
+    std::uint64_t generation;
+};
+
+static const char snapshotMagic[4] = { 'C', 'W', 'Y', '1' };
+
+static size_t snapshotBytes(int size)
+{
+    size_t wordsPerRow = ((size_t)size + 63) / 64;
+    return sizeof(SnapshotHeader) + wordsPerRow * size * sizeof(std::uint64_t);
+}
+
+//Maps a file into memory. For writing the file is created (or truncated)
+//at the requested length first; for reading the length comes back in
+//outLength. Returns nullptr on any failure.
+#ifdef _WIN32
+
+struct MappedFile
+{
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+    void* view = nullptr;
+};
+
+static void* mapFile(const char* path, bool writing, size_t length, size_t& outLength, MappedFile& mapped)
+{
+    mapped.file = CreateFileA(path,
+        writing ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+        0, NULL,
+        writing ? CREATE_ALWAYS : OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mapped.file == INVALID_HANDLE_VALUE) return nullptr;
+
+    if (!writing)
+    {
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(mapped.file, &fileSize)) return nullptr;
+        length = (size_t)fileSize.QuadPart;
+    }
+    outLength = length;
+
+    mapped.mapping = CreateFileMappingA(mapped.file, NULL,
+        writing ? PAGE_READWRITE : PAGE_READONLY,
+        (DWORD)((std::uint64_t)length >> 32), (DWORD)length, NULL);
+    if (!mapped.mapping) return nullptr;
+
+    mapped.view = MapViewOfFile(mapped.mapping,
+        writing ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, length);
+    return mapped.view;
+}
+
+static void unmapFile(MappedFile& mapped)
+{
+    if (mapped.view) UnmapViewOfFile(mapped.view);
+    if (mapped.mapping) CloseHandle(mapped.mapping);
+    if (mapped.file != INVALID_HANDLE_VALUE) CloseHandle(mapped.file);
+}
+
+#else
+
+struct MappedFile
+{
+    int file = -1;
+    void* view = nullptr;
+    size_t length = 0;
+};
+
+static void* mapFile(const char* path, bool writing, size_t length, size_t& outLength, MappedFile& mapped)
+{
+    mapped.file = writing
+        ? open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)
+        : open(path, O_RDONLY);
+    if (mapped.file < 0) return nullptr;
+
+    if (writing)
+    {
+        if (ftruncate(mapped.file, (off_t)length) != 0) return nullptr;
+    }
+    else
+    {
+        struct stat info;
+        if (fstat(mapped.file, &info) != 0) return nullptr;
+        length = (size_t)info.st_size;
+    }
+    outLength = length;
+    mapped.length = length;
+
+    mapped.view = mmap(NULL, length,
+        writing ? PROT_READ | PROT_WRITE : PROT_READ,
+        MAP_SHARED, mapped.file, 0);
+    if (mapped.view == MAP_FAILED) mapped.view = nullptr;
+    return mapped.view;
+}
+
+static void unmapFile(MappedFile& mapped)
+{
+    if (mapped.view) munmap(mapped.view, mapped.length);
+    if (mapped.file >= 0) close(mapped.file);
+}
+
+#endif
+
+bool saveSnapshot(const char* path, const Simulation& sim)
+{
+    int size = sim.getSize();
+    size_t length = snapshotBytes(size);
+
+    MappedFile mapped;
+    size_t mappedLength = 0;
+    void* view = mapFile(path, true, length, mappedLength, mapped);
+    if (!view)
+    {
+        std::cout << "Couldn't create snapshot: " << path << std::endl;
+        unmapFile(mapped);
+        return false;
+    }
+
+    SnapshotHeader* header = (SnapshotHeader*)view;
+    std::memcpy(header->magic, snapshotMagic, 4);
+    header->size = (std::uint32_t)size;
+    header->generation = sim.getGeneration();
+
+    //Pack straight into the mapped view; the OS pages it out behind us.
+    std::uint64_t* words = (std::uint64_t*)(header + 1);
+    size_t wordsPerRow = ((size_t)size + 63) / 64;
+
+    for (int i = 0; i < size; i++)
+    {
+        std::uint64_t* row = words + (size_t)i * wordsPerRow;
+        std::memset(row, 0, wordsPerRow * sizeof(std::uint64_t));
+        for (int j = 0; j < size; j++)
+        {
+            if (sim.isAlive(i, j)) row[j / 64] |= 1ull << (j % 64);
+        }
+    }
+
+    unmapFile(mapped);
+    return true;
+}
+
+int snapshotBoardSize(const char* path)
+{
+    MappedFile mapped;
+    size_t length = 0;
+    void* view = mapFile(path, false, 0, length, mapped);
+
+    int size = 0;
+    if (view && length >= sizeof(SnapshotHeader))
+    {
+        SnapshotHeader* header = (SnapshotHeader*)view;
+        if (std::memcmp(header->magic, snapshotMagic, 4) == 0) size = (int)header->size;
+    }
+
+    unmapFile(mapped);
+    return size;
+}
+
+bool loadSnapshot(const char* path, Simulation& sim)
+{
+    MappedFile mapped;
+    size_t length = 0;
+    void* view = mapFile(path, false, 0, length, mapped);
+    if (!view || length < sizeof(SnapshotHeader))
+    {
+        std::cout << "Couldn't open snapshot: " << path << std::endl;
+        unmapFile(mapped);
+        return false;
+    }
+
+    SnapshotHeader* header = (SnapshotHeader*)view;
+    int size = (int)header->size;
+
+    if (std::memcmp(header->magic, snapshotMagic, 4) != 0
+        || size != sim.getSize()
+        || length < snapshotBytes(size))
+    {
+        std::cout << "Snapshot doesn't match this board: " << path << std::endl;
+        unmapFile(mapped);
+        return false;
+    }
+
+    sim.clear();
+    sim.setGeneration(header->generation);
+
+    const std::uint64_t* words = (const std::uint64_t*)(header + 1);
+    size_t wordsPerRow = ((size_t)size + 63) / 64;
+
+    for (int i = 0; i < size; i++)
+    {
+        const std::uint64_t* row = words + (size_t)i * wordsPerRow;
+        for (int j = 0; j < size; j++)
+        {
+            if (row[j / 64] & (1ull << (j % 64))) sim.setAlive(i, j, true);
+        }
+    }
+
+    unmapFile(mapped);
+    return true;
+}
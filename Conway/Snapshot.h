@@ -0,0 +1,18 @@
+#pragma once
+
+class Simulation;
+
+//Binary checkpoints for long runs. The format is a fixed layout: a 4 byte
+//magic ("CWY1"), the board size, the generation counter, then the grid
+//bit-packed 64 cells per word. Both directions go through a memory-mapped
+//file, so a multi-hundred-megabyte board never passes through an
+//intermediate serialization buffer.
+
+bool saveSnapshot(const char* path, const Simulation& sim);
+
+//Peeks at the header so the caller can construct a Simulation of the right
+//size before loading. Returns 0 if the file is missing or not a snapshot.
+int snapshotBoardSize(const char* path);
+
+//The Simulation must already be the size reported by snapshotBoardSize.
+bool loadSnapshot(const char* path, Simulation& sim);
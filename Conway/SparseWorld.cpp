@@ -0,0 +1,232 @@
+#include "SparseWorld.h"
+
+#include <bitset>
+#include <cstring>
+#include <unordered_set>
+
+#include "Simulation.h"
+
+//Splits a signed cell coordinate into tile index and row/bit within the tile.
+//The arithmetic shift rounds towards negative infinity, which is what we want
+//for tiles left of / above the origin.
+static std::int32_t tileIndex(std::int64_t coord)
+{
+    return (std::int32_t)(coord >> 6);
+}
+
+static int tileOffset(std::int64_t coord)
+{
+    return (int)(coord & 63);
+}
+
+SparseWorld::Tile* SparseWorld::newTile()
+{
+    Tile* tile = (Tile*)this->arena.allocate(sizeof(Tile));
+    std::memset(tile->rows, 0, sizeof(tile->rows));
+    return tile;
+}
+
+bool SparseWorld::getCell(std::int64_t row, std::int64_t col) const
+{
+    auto it = this->tiles.find(tileKey(tileIndex(row), tileIndex(col)));
+    if (it == this->tiles.end()) return false;
+    return (it->second->rows[tileOffset(row)] >> tileOffset(col)) & 1;
+}
+
+void SparseWorld::setCell(std::int64_t row, std::int64_t col, bool alive)
+{
+    std::uint64_t key = tileKey(tileIndex(row), tileIndex(col));
+    std::uint64_t bit = (std::uint64_t)1 << tileOffset(col);
+
+    if (alive)
+    {
+        Tile*& slot = this->tiles[key];
+        if (!slot) slot = this->newTile();
+        slot->rows[tileOffset(row)] |= bit;
+        return;
+    }
+
+    auto it = this->tiles.find(key);
+    if (it == this->tiles.end()) return;
+    it->second->rows[tileOffset(row)] &= ~bit;
+
+    //Free the tile if that was its last cell.
+    for (int r = 0; r < 64; r++)
+    {
+        if (it->second->rows[r]) return;
+    }
+    this->arena.release(it->second, sizeof(Tile));
+    this->tiles.erase(it);
+}
+
+std::uint64_t SparseWorld::fetchRow(std::int32_t tileRow, std::int32_t tileCol, int row) const
+{
+    if (row < 0) { tileRow--; row += 64; }
+    else if (row > 63) { tileRow++; row -= 64; }
+
+    auto it = this->tiles.find(tileKey(tileRow, tileCol));
+    if (it == this->tiles.end()) return 0;
+    return it->second->rows[row];
+}
+
+//Computes the next generation of one tile, reading halo cells from the eight
+//surrounding tiles (missing tiles read as empty space). Returns false when
+//the resulting tile is fully dead, so the caller can simply not keep it.
+bool SparseWorld::stepTile(std::int32_t tileRow, std::int32_t tileCol, Tile& out) const
+{
+    std::uint64_t any = 0;
+
+    for (int r = 0; r < 64; r++)
+    {
+        //Neighbour counts of all 64 cells at once, in the same three bit
+        //planes (ones, twos, fours) the BitGrid kernel uses.
+        std::uint64_t ones = 0, twos = 0, fours = 0;
+
+        auto add = [&](std::uint64_t n)
+        {
+            std::uint64_t carry = ones & n;
+            ones ^= n;
+            fours |= twos & carry;
+            twos ^= carry;
+        };
+
+        std::uint64_t curr = 0;
+
+        for (int dr = -1; dr <= 1; dr++)
+        {
+            std::uint64_t mid   = this->fetchRow(tileRow, tileCol, r + dr);
+            std::uint64_t left  = this->fetchRow(tileRow, tileCol - 1, r + dr);
+            std::uint64_t right = this->fetchRow(tileRow, tileCol + 1, r + dr);
+
+            //Bit j is column j, so the col-1 neighbours are a shift towards
+            //the high bits, pulling the crossing bit in from the next tile.
+            add((mid << 1) | (left >> 63));
+            add((mid >> 1) | (right << 63));
+            if (dr != 0) add(mid);
+            else curr = mid;
+        }
+
+        std::uint64_t next = ~fours & twos & (ones | curr);
+        out.rows[r] = next;
+        any |= next;
+    }
+
+    return any != 0;
+}
+
+void SparseWorld::step()
+{
+    //tilesNext still holds the generation before last; its tiles go back to
+    //the arena and come straight out again for this generation's results.
+    for (auto it = this->tilesNext.begin(); it != this->tilesNext.end(); ++it)
+    {
+        this->arena.release(it->second, sizeof(Tile));
+    }
+    this->tilesNext.clear();
+
+    //Cells can only appear in a live tile or one of its eight neighbours, so
+    //that is the whole candidate set; the visited set keeps a tile with
+    //several live neighbours from being stepped more than once.
+    std::unordered_set<std::uint64_t> visited;
+
+    for (auto it = this->tiles.begin(); it != this->tiles.end(); ++it)
+    {
+        std::int32_t tileRow = (std::int32_t)(it->first >> 32);
+        std::int32_t tileCol = (std::int32_t)(it->first & 0xFFFFFFFFull);
+
+        for (int dr = -1; dr <= 1; dr++)
+        {
+            for (int dc = -1; dc <= 1; dc++)
+            {
+                std::uint64_t key = tileKey(tileRow + dr, tileCol + dc);
+                if (!visited.insert(key).second) continue;
+
+                //Raw allocation: stepTile writes every row, no zeroing needed.
+                Tile* next = (Tile*)this->arena.allocate(sizeof(Tile));
+                if (this->stepTile(tileRow + dr, tileCol + dc, *next))
+                {
+                    this->tilesNext[key] = next;
+                }
+                else
+                {
+                    //Came out dead: straight back onto the freelist.
+                    this->arena.release(next, sizeof(Tile));
+                }
+            }
+        }
+    }
+
+    std::swap(this->tiles, this->tilesNext);
+    this->generation++;
+}
+
+void SparseWorld::run(std::uint64_t generations)
+{
+    for (std::uint64_t g = 0; g < generations; g++)
+    {
+        this->step();
+    }
+}
+
+std::uint64_t SparseWorld::getPopulation() const
+{
+    std::uint64_t population = 0;
+    for (auto it = this->tiles.begin(); it != this->tiles.end(); ++it)
+    {
+        for (int r = 0; r < 64; r++)
+        {
+            population += std::bitset<64>(it->second->rows[r]).count();
+        }
+    }
+    return population;
+}
+
+void SparseWorld::loadFrom(const Simulation& sim)
+{
+    //World clear: both maps drop their pointers and the arena takes every
+    //block back in one go.
+    this->tiles.clear();
+    this->tilesNext.clear();
+    this->arena.reset();
+    this->generation = 0;
+
+    //Centered on the origin, so an expanding pattern grows in every direction.
+    int size = sim.getSize();
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = 0; j < size; j++)
+        {
+            if (sim.isAlive(i, j)) this->setCell(i - size / 2, j - size / 2, true);
+        }
+    }
+}
+
+void SparseWorld::writeTo(Simulation& sim) const
+{
+    sim.clear();
+
+    int size = sim.getSize();
+    for (auto it = this->tiles.begin(); it != this->tiles.end(); ++it)
+    {
+        std::int64_t baseRow = (std::int64_t)(std::int32_t)(it->first >> 32) * 64;
+        std::int64_t baseCol = (std::int64_t)(std::int32_t)(it->first & 0xFFFFFFFFull) * 64;
+
+        for (int r = 0; r < 64; r++)
+        {
+            std::uint64_t word = it->second->rows[r];
+            if (!word) continue;
+
+            for (int c = 0; c < 64; c++)
+            {
+                if (!((word >> c) & 1)) continue;
+
+                std::int64_t row = baseRow + r + size / 2;
+                std::int64_t col = baseCol + c + size / 2;
+                if (row >= 0 && row < size && col >= 0 && col < size)
+                {
+                    sim.setAlive((int)row, (int)col, true);
+                }
+            }
+        }
+    }
+}
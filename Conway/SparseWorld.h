@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "Arena.h"
+
+class Simulation;
+
+//Sparse engine: the plane is cut into 64x64 bit-packed tiles kept in a hash
+//map, and a tile only exists while it (or a neighbour leaking cells into it)
+//has live cells. Memory scales with the population instead of the bounding
+//box, and patterns can expand indefinitely. Like Hashlife this simulates an
+//unbounded plane, so results only match the walled array engine while the
+//pattern stays away from the board edge. Tiles come out of an Arena: dead
+//ones are recycled through its freelist instead of hitting the heap, so a
+//long run neither fragments nor spends time in the allocator.
+class SparseWorld
+{
+    //One row per word, so a tile row is a single uint64 and the bitwise
+    //full-adder kernel from BitGrid carries over unchanged.
+    struct Tile
+    {
+        std::uint64_t rows[64] = {};
+    };
+
+    //Tile coordinates are signed; the key packs them into one word.
+    static std::uint64_t tileKey(std::int32_t tileRow, std::int32_t tileCol)
+    {
+        return ((std::uint64_t)(std::uint32_t)tileRow << 32) | (std::uint32_t)tileCol;
+    }
+
+    Arena arena;
+    std::unordered_map<std::uint64_t, Tile*> tiles;
+    std::unordered_map<std::uint64_t, Tile*> tilesNext;
+
+    std::uint64_t generation = 0;
+
+    //A zeroed tile out of the arena (setCell needs one; step() fills every
+    //row anyway and allocates raw).
+    Tile* newTile();
+
+    //The stored row, or 0 where no tile exists (empty space is implicit).
+    std::uint64_t fetchRow(std::int32_t tileRow, std::int32_t tileCol, int row) const;
+
+    bool stepTile(std::int32_t tileRow, std::int32_t tileCol, Tile& out) const;
+
+public:
+
+    bool getCell(std::int64_t row, std::int64_t col) const;
+    void setCell(std::int64_t row, std::int64_t col, bool alive);
+
+    //Copies the live cells out of / back into the array engine. writeTo clips
+    //anything that expanded past the board.
+    void loadFrom(const Simulation& sim);
+    void writeTo(Simulation& sim) const;
+
+    //Advances one generation: every live tile and its neighbours are stepped,
+    //and tiles that come out fully dead are simply not kept.
+    void step();
+
+    void run(std::uint64_t generations);
+
+    std::uint64_t getGeneration() const { return this->generation; }
+    std::uint64_t getPopulation() const;
+    size_t getTileCount() const { return this->tiles.size(); }
+
+    //For the benchmark's allocator readout (hit rate, reserved bytes).
+    const Arena& getArena() const { return this->arena; }
+};
@@ -1,25 +1,52 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
 #include <vector>
 
-constexpr int numberOfSeparators = 80;
+#include "FrameStats.h"
+#include "HashLife.h"
+#include "History.h"
+#include "RleLoader.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+
+constexpr int numberOfSeparators = 80;  //default board size, override with argv[1]
 constexpr int windowWidth        = 1200;
 constexpr int windowHeight       = 1200;
 constexpr float viewPortLeft     = -1.0f;
 constexpr float viewPortRight    = 1.0f;
-constexpr float viewPortTop      = 1.0f; 
+constexpr float viewPortTop      = 1.0f;
 constexpr float viewPortBottom   = -1.0f;
 constexpr float viewPortSize     = 2.0f;
-constexpr float gridSquareSize   = viewPortSize / numberOfSeparators;
 
+//These two were compile-time constants; now they follow the runtime board size.
+static int boardSize       = numberOfSeparators;
+static float gridSquareSize = viewPortSize / numberOfSeparators;
+
+//aOffset is a per-instance attribute. Drawables that don't enable it (the Grid)
+//get the default value of (0, 0), so they can keep using the trans uniform alone.
+//camOffset/camScale are the camera: world positions are shifted to the camera
+//center and scaled by the zoom, so panning and zooming never touch geometry.
 constexpr const char* vertexShaderSource = "#version 330 core\n"
 "layout (location = 0) in vec3 aPos;\n"
+"layout (location = 1) in vec2 aOffset;\n"
 "uniform vec2 trans;"
+"uniform vec2 camOffset;"
+"uniform float camScale;"
 "void main()\n"
 "{\n"
-"   gl_Position = vec4(aPos.x + trans.x, aPos.y + trans.y, aPos.z, 1.0);\n"
+"   gl_Position = vec4((aPos.x + trans.x + aOffset.x - camOffset.x) * camScale, (aPos.y + trans.y + aOffset.y - camOffset.y) * camScale, aPos.z, 1.0);\n"
 "}\0";
 
 constexpr const char* fragmentShaderSource = "#version 330 core\n"
@@ -29,9 +56,314 @@ constexpr const char* fragmentShaderSource = "#version 330 core\n"
 "    FragColor = vec4(1.0f, 1.0f, 1.0f, 1.0f);\n"
 "}\0";
 
-static bool mapGrid[numberOfSeparators][numberOfSeparators] = { false };
+//GPU backend shaders. The GL 3.3 core context has no compute shaders, so a
+//generation is one fragment-shader pass ping-ponging between two textures.
+//Attribute-less fullscreen triangle, needs nothing but an empty VAO.
+constexpr const char* fullscreenVertexShaderSource = "#version 330 core\n"
+"void main()\n"
+"{\n"
+"    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;\n"
+"    gl_Position = vec4(pos, 0.0, 1.0);\n"
+"}\0";
+
+constexpr const char* lifeStepFragmentShaderSource = "#version 330 core\n"
+"out vec4 FragColor;\n"
+"uniform sampler2D state;\n"
+"void main()\n"
+"{\n"
+"    ivec2 p = ivec2(gl_FragCoord.xy);\n"
+"    ivec2 sz = textureSize(state, 0);\n"
+"    int aliveNeighbours = 0;\n"
+"    for (int y = -1; y <= 1; y++)\n"
+"    {\n"
+"        for (int x = -1; x <= 1; x++)\n"
+"        {\n"
+"            if (x == 0 && y == 0) continue;\n"
+"            ivec2 q = p + ivec2(x, y);\n"
+"            if (q.x < 0 || q.y < 0 || q.x >= sz.x || q.y >= sz.y) continue;\n"
+"            if (texelFetch(state, q, 0).r > 0.5) aliveNeighbours++;\n"
+"        }\n"
+"    }\n"
+"    bool alive = texelFetch(state, p, 0).r > 0.5;\n"
+"    bool next = aliveNeighbours == 3 || (alive && aliveNeighbours == 2);\n"
+"    FragColor = vec4(next ? 1.0 : 0.0, 0.0, 0.0, 1.0);\n"
+"}\0";
+
+constexpr const char* boardDisplayFragmentShaderSource = "#version 330 core\n"
+"out vec4 FragColor;\n"
+"uniform sampler2D state;\n"
+"uniform vec2 viewSize;\n"
+"uniform vec2 camOffset;\n"
+"uniform float camScale;\n"
+"void main()\n"
+"{\n"
+"    vec2 ndc = gl_FragCoord.xy / viewSize * 2.0 - 1.0;\n"
+"    vec2 uv = (ndc / camScale + camOffset + 1.0) * 0.5;\n"
+"    if (uv.x < 0.0 || uv.y < 0.0 || uv.x > 1.0 || uv.y > 1.0)\n"
+"    {\n"
+"        FragColor = vec4(0.0, 0.0, 0.0, 1.0);\n"
+"        return;\n"
+"    }\n"
+"    float cell = texture(state, uv).r;\n"
+"    FragColor = vec4(cell, cell, cell, 1.0);\n"
+"}\0";
+
+static Simulation* simulation = nullptr;
 static bool simulationRunning = false;
 
+//Rewind ring (R key, while paused). Only kept for the CPU engines; size set
+//with --history, 0 disables it.
+static History* history = nullptr;
+
+//Set when the CPU-side grid is edited so the GPU backend (if active) knows to
+//re-upload its state texture.
+static bool gpuStateDirty = false;
+
+//Generations to fast-forward through the HashLife engine (F key, while
+//paused). The array engine stays the interactive editing backend.
+static std::uint64_t fastForwardGenerations = 0;
+
+//Target generations per second; 0 means unlimited (simulate flat out between
+//frames). Set with --gps. Rendering is paced separately by fpsLimit.
+static double generationsPerSecond = 15.0;
+
+//T toggles the timing readout (window title + console once a second).
+static bool statsVisible = false;
+
+//Camera: center of the view in world coordinates (the full board spans the
+//viewPort constants) and the zoom factor. Arrow keys pan, the scroll wheel
+//zooms about the cursor, Home resets.
+static float cameraX = 0.0f;
+static float cameraY = 0.0f;
+static float cameraZoom = 1.0f;
+
+//Editing tools (paused only). Left drag paints with a square brush ([ and ]
+//halve/double it), Shift held while pressing erases instead. Right drag
+//spans a rectangle: plain release fills it, Shift clears it, Ctrl fills it
+//with a 30% random soup. All of them land as one batched setRegion /
+//fillRegionRandom call, not one event per cell.
+static int brushSize = 1;
+static bool painting = false;
+static bool erasing = false;
+static int lastPaintRow = 0;
+static int lastPaintCol = 0;
+static bool rectDragging = false;
+static int rectAnchorRow = 0;
+static int rectAnchorCol = 0;
+
+//Runs the CPU simulation on its own thread, so the GLFW thread never blocks
+//on a generation: the window stays responsive no matter how big the board is,
+//and the simulation and render rates are free to diverge. Completed boards
+//are handed over through a triple buffer (write / ready / read slot, swapped
+//with atomic exchanges), so neither side ever waits for the other; the render
+//thread just picks up whatever generation was published last. Pausing parks
+//the thread on a condition variable, and setRunning(false) doubles as a
+//barrier: once it returns, the GLFW thread can edit the Simulation directly
+//like it always has.
+//
+//While paused the thread doesn't just sit there: a private twin of the board
+//runs ahead and banks each future generation into the history ring (users
+//invariably un-pause moments later, and then the banked generations replay
+//for the cost of their flips instead of full simulation passes). Edits go
+//through beginBoardEdit/endBoardEdit, which throw the bank away - the board
+//the user sees and touches is never ahead of where they paused it.
+class SimThread
+{
+    Simulation& sim;
+    std::thread worker;
+    std::mutex mutex;               //held by the thread while it steps the sim
+    std::condition_variable wake;
+    std::atomic<bool> running{ false };
+    std::atomic<bool> quitting{ false };
+
+    //The thread fills slots[writeSlot] and swaps it with the ready slot;
+    //acquire() swaps the ready slot with the read slot.
+    std::vector<std::uint8_t> slots[3];
+    int writeSlot = 0;
+    int readSlot = 2;
+    std::atomic<int> readySlot{ 1 };
+    std::atomic<bool> fresh{ false };
+
+    //Simulation time accrued since the render thread last asked; feeds the
+    //stats readout across the thread boundary.
+    std::atomic<long long> simNanos{ 0 };
+
+    //Run-ahead speculation. The twin mirrors the board (specValid says the
+    //mirror plus the banked deltas are current); specArmed goes false while
+    //the GLFW thread is mid-edit so we never race a brush stroke.
+    Simulation spec;
+    std::vector<std::uint8_t> specScratch;
+    std::atomic<bool> specArmed{ true };
+    bool specValid = false;
+
+    bool canSpeculate() const
+    {
+        //Banking stops at half the ring so rewind depth survives, and a
+        //stale twin only restarts from an empty bank (a pause mid-playback
+        //keeps what is left banked instead of re-banking on top of it).
+        return !this->running.load() && this->specArmed.load() && history
+            && (this->specValid || history->getFutureCount() == 0)
+            && history->getFutureCount() * 2 < history->getCapacity();
+    }
+
+    void loop()
+    {
+        while (true)
+        {
+            double spentSeconds = 0;
+            bool paced = false;
+
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->wake.wait(lock, [this] { return this->quitting.load() || this->running.load() || this->canSpeculate(); });
+                if (this->quitting.load()) return;
+
+                if (this->running.load())
+                {
+                    auto t0 = std::chrono::steady_clock::now();
+
+                    //A banked generation replays for the cost of its flips;
+                    //only when the bank runs dry do we simulate for real.
+                    if (!history || !history->stepForward(this->sim))
+                    {
+                        this->sim.update();
+                        if (history) history->record(this->sim);
+                    }
+                    this->specValid = false;
+
+                    auto t1 = std::chrono::steady_clock::now();
+                    this->simNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+                    spentSeconds = std::chrono::duration<double>(t1 - t0).count();
+
+                    //Skip the copy while the render thread hasn't picked up the
+                    //previous publish; it only ever wants the newest generation.
+                    if (!this->fresh.load())
+                    {
+                        this->sim.copyCellsTo(this->slots[this->writeSlot]);
+                        this->writeSlot = this->readySlot.exchange(this->writeSlot);
+                        this->fresh.store(true);
+                    }
+                    paced = true;
+                }
+                else
+                {
+                    //Paused: run the twin one generation ahead and bank the
+                    //delta. The board itself is never touched, so the GLFW
+                    //thread keeps rendering and reading it freely.
+                    if (!this->specValid)
+                    {
+                        //Edits made while paused aren't in the ring yet;
+                        //bank them first so the speculated chain (and a
+                        //later rewind) starts from the board as it is.
+                        history->recordEdits(this->sim);
+
+                        this->sim.copyCellsTo(this->specScratch);
+                        this->spec.copyCellsFrom(this->specScratch);
+                        this->spec.setGeneration(this->sim.getGeneration());
+                        this->specValid = true;
+                    }
+                    this->spec.update();
+                    history->recordSpeculative(this->spec);
+                }
+            }
+
+            //Pacing happens outside the lock, so a pause never waits on it.
+            //Time spent simulating counts against the budget; if a generation
+            //overruns it we just run the next one immediately, no spiral.
+            //Speculation is never paced - it banks flat out until its cap.
+            if (paced && generationsPerSecond > 0.0)
+            {
+                double step = 1.0 / generationsPerSecond;
+                if (spentSeconds < step)
+                {
+                    std::this_thread::sleep_for(std::chrono::duration<double>(step - spentSeconds));
+                }
+            }
+        }
+    }
+
+public:
+
+    SimThread(Simulation& sim) : sim(sim), spec(sim.getSize())
+    {
+        //The twin steps with the same kernel, so the banked generations are
+        //exactly what the board itself would have computed.
+        this->spec.setKernel(sim.getKernel());
+        this->spec.setTopology(sim.getTopology());
+        this->worker = std::thread(&SimThread::loop, this);
+    }
+
+    ~SimThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->quitting.store(true);
+        }
+        this->wake.notify_one();
+        this->worker.join();
+    }
+
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    void setRunning(bool run)
+    {
+        {
+            //The store has to happen under the mutex: otherwise it can land
+            //between the worker's predicate check and its block inside
+            //wait(), and the notify below is lost - a SPACE press that
+            //silently never starts. Taking the mutex also waits out any
+            //in-flight generation, so after a pause returns the Simulation
+            //is ours.
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->running.store(run);
+        }
+        if (run) this->wake.notify_one();
+    }
+
+    //Brackets any board mutation from the GLFW thread while paused. Disarming
+    //before taking the mutex keeps the thread from re-grabbing it for the
+    //next speculation step; holding the mutex waits out any step in flight;
+    //and the banked future describes a board the edit is about to
+    //invalidate, so it is dropped.
+    void beginBoardEdit()
+    {
+        this->specArmed.store(false);
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (history) history->discardSpeculation();
+        this->specValid = false;
+    }
+
+    void endBoardEdit()
+    {
+        {
+            //Under the mutex for the same missed-wakeup reason as
+            //setRunning.
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->specArmed.store(true);
+        }
+        this->wake.notify_one();
+    }
+
+    //The newest published generation, or nullptr if nothing new arrived since
+    //the last call (the caller keeps whatever it rendered last).
+    const std::vector<std::uint8_t>* acquire()
+    {
+        if (!this->fresh.exchange(false)) return nullptr;
+        this->readSlot = this->readySlot.exchange(this->readSlot);
+        return &this->slots[this->readSlot];
+    }
+
+    double takeSimSeconds()
+    {
+        return this->simNanos.exchange(0) * 1e-9;
+    }
+};
+
+//Only set when a CPU engine is active; the GPU backend steps with GL calls
+//and those have to stay on the context thread.
+static SimThread* simThread = nullptr;
+
 void error_callback(int error, const char* description)
 {
     fprintf(stderr, "Error: %s\n", description);
@@ -46,6 +378,78 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     else if (key == GLFW_KEY_SPACE && action == GLFW_PRESS)
     {
         simulationRunning = !simulationRunning;
+
+        //Told here rather than in the main loop so that by the time any other
+        //callback in this poll batch touches the board, the thread is parked.
+        if (simThread) simThread->setRunning(simulationRunning);
+    }
+    else if (key == GLFW_KEY_F && action == GLFW_PRESS && !simulationRunning)
+    {
+        fastForwardGenerations = 1024;
+    }
+    else if (key == GLFW_KEY_S && action == GLFW_PRESS && !simulationRunning)
+    {
+        if (saveSnapshot("snapshot.bin", *simulation))
+        {
+            std::cout << "Saved snapshot.bin (generation "
+                      << simulation->getGeneration() << ")" << std::endl;
+        }
+    }
+    else if (key == GLFW_KEY_L && action == GLFW_PRESS && !simulationRunning)
+    {
+        if (simThread) simThread->beginBoardEdit();
+        if (loadSnapshot("snapshot.bin", *simulation))
+        {
+            gpuStateDirty = true;
+
+            //The old deltas describe a board that no longer exists.
+            if (history)
+            {
+                history->clear();
+                history->record(*simulation);
+            }
+        }
+        if (simThread) simThread->endBoardEdit();
+    }
+    else if (key == GLFW_KEY_R && action == GLFW_PRESS && !simulationRunning)
+    {
+        if (simThread) simThread->beginBoardEdit();
+        if (history && history->stepBack(*simulation))
+        {
+            gpuStateDirty = true;
+        }
+        if (simThread) simThread->endBoardEdit();
+    }
+    else if (key == GLFW_KEY_T && action == GLFW_PRESS)
+    {
+        statsVisible = !statsVisible;
+        if (!statsVisible) glfwSetWindowTitle(window, "Conways");
+    }
+    else if ((action == GLFW_PRESS || action == GLFW_REPEAT) &&
+             (key == GLFW_KEY_LEFT || key == GLFW_KEY_RIGHT ||
+              key == GLFW_KEY_UP || key == GLFW_KEY_DOWN))
+    {
+        //Pan a fixed fraction of the visible window, so it feels the same at
+        //every zoom level.
+        float step = 0.1f / cameraZoom;
+        if (key == GLFW_KEY_LEFT)  cameraX -= step;
+        if (key == GLFW_KEY_RIGHT) cameraX += step;
+        if (key == GLFW_KEY_DOWN)  cameraY -= step;
+        if (key == GLFW_KEY_UP)    cameraY += step;
+    }
+    else if (key == GLFW_KEY_HOME && action == GLFW_PRESS)
+    {
+        cameraX = 0.0f;
+        cameraY = 0.0f;
+        cameraZoom = 1.0f;
+    }
+    else if (key == GLFW_KEY_LEFT_BRACKET && action == GLFW_PRESS)
+    {
+        if (brushSize > 1) brushSize /= 2;
+    }
+    else if (key == GLFW_KEY_RIGHT_BRACKET && action == GLFW_PRESS)
+    {
+        if (brushSize < 64) brushSize *= 2;
     }
 }
 
@@ -54,23 +458,267 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
     glViewport(0, 0, width, height);
 }
 
+//Window -> view -> world (undoing the camera) -> cell. May land outside the
+//board; the batched region calls clip, so callers don't have to.
+static void cellFromCursor(double xpos, double ypos, int& row, int& col)
+{
+    double ndcX = (xpos / windowWidth) * 2.0 - 1.0;
+    double ndcY = ((windowHeight - ypos) / windowHeight) * 2.0 - 1.0;
+    double worldX = ndcX / cameraZoom + cameraX;
+    double worldY = ndcY / cameraZoom + cameraY;
+    col = (int)( (worldX - viewPortLeft) / gridSquareSize );
+    row = (int)( (worldY - viewPortBottom) / gridSquareSize );
+}
+
+//One brush stamp, centered on the cell; a single region write however big
+//the brush is.
+static void stampBrush(int row, int col)
+{
+    simulation->setRegion(row - brushSize / 2, col - brushSize / 2,
+                          brushSize, brushSize, !erasing);
+    gpuStateDirty = true;
+}
+
 static void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
     if (simulationRunning) return;
 
-    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+    //Any press starts a board edit, so the banked run-ahead (if any) has to
+    //go before the first stamp lands.
+    if (action == GLFW_PRESS && simThread) simThread->beginBoardEdit();
+
+    double xpos, ypos;
+    //getting cursor position
+    glfwGetCursorPos(window, &xpos, &ypos);
+    int row, col;
+    cellFromCursor(xpos, ypos, row, col);
+
+    if (button == GLFW_MOUSE_BUTTON_LEFT)
+    {
+        if (action == GLFW_PRESS)
+        {
+            painting = true;
+            erasing = (mods & GLFW_MOD_SHIFT) != 0;
+
+            //With the 1-cell brush a click still feels like the old toggle:
+            //pressing on a live cell starts an erasing stroke.
+            if (!erasing && brushSize == 1
+                && row >= 0 && row < boardSize && col >= 0 && col < boardSize)
+            {
+                erasing = simulation->isAlive(row, col);
+            }
+
+            lastPaintRow = row;
+            lastPaintCol = col;
+            stampBrush(row, col);
+        }
+        else if (action == GLFW_RELEASE)
+        {
+            painting = false;
+        }
+    }
+    else if (button == GLFW_MOUSE_BUTTON_RIGHT)
+    {
+        if (action == GLFW_PRESS)
+        {
+            rectDragging = true;
+            rectAnchorRow = row;
+            rectAnchorCol = col;
+        }
+        else if (action == GLFW_RELEASE && rectDragging)
+        {
+            rectDragging = false;
+
+            int rowBegin = rectAnchorRow < row ? rectAnchorRow : row;
+            int colBegin = rectAnchorCol < col ? rectAnchorCol : col;
+            int height = (rectAnchorRow < row ? row - rectAnchorRow : rectAnchorRow - row) + 1;
+            int width = (rectAnchorCol < col ? col - rectAnchorCol : rectAnchorCol - col) + 1;
+
+            if (mods & GLFW_MOD_CONTROL)
+            {
+                simulation->fillRegionRandom(rowBegin, colBegin, height, width,
+                                             30, (unsigned int)(glfwGetTime() * 1000.0));
+            }
+            else
+            {
+                simulation->setRegion(rowBegin, colBegin, height, width,
+                                      (mods & GLFW_MOD_SHIFT) == 0);
+            }
+            gpuStateDirty = true;
+        }
+    }
+
+    //Speculation restarts (from the edited board) only once the whole
+    //gesture is over - a release of one button mid-drag of the other
+    //doesn't count.
+    if (action == GLFW_RELEASE && !painting && !rectDragging && simThread)
+    {
+        simThread->endBoardEdit();
+    }
+}
+
+//Drag-to-paint: stamps the brush along the cursor path. The segment from the
+//previous event is walked so a fast drag leaves a solid stroke, not dots.
+static void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if (!painting || simulationRunning) return;
+
+    int row, col;
+    cellFromCursor(xpos, ypos, row, col);
+
+    int dRow = row - lastPaintRow;
+    int dCol = col - lastPaintCol;
+    int steps = dRow < 0 ? -dRow : dRow;
+    int dColAbs = dCol < 0 ? -dCol : dCol;
+    if (dColAbs > steps) steps = dColAbs;
+
+    for (int s = 1; s <= steps; s++)
     {
-        double xpos, ypos;
-        //getting cursor position
-        glfwGetCursorPos(window, &xpos, &ypos);
-		int x = (int)( (xpos / windowWidth) * numberOfSeparators );
-		int y = (int)( ( (windowHeight - ypos ) / windowHeight) * numberOfSeparators );
+        stampBrush(lastPaintRow + dRow * s / steps, lastPaintCol + dCol * s / steps);
+    }
 
-		if (x < 0 || x >= numberOfSeparators || y < 0 || y >= numberOfSeparators) return;
+    lastPaintRow = row;
+    lastPaintCol = col;
+}
 
-		mapGrid[y][x] = !mapGrid[y][x];
+//Scroll zooms about the cursor, so whatever is under the pointer stays put.
+static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    double xpos, ypos;
+    glfwGetCursorPos(window, &xpos, &ypos);
+    double ndcX = (xpos / windowWidth) * 2.0 - 1.0;
+    double ndcY = ((windowHeight - ypos) / windowHeight) * 2.0 - 1.0;
+    double worldX = ndcX / cameraZoom + cameraX;
+    double worldY = ndcY / cameraZoom + cameraY;
+
+    cameraZoom *= (float)pow(1.2, yoffset);
+    if (cameraZoom < 0.25f) cameraZoom = 0.25f;
+    if (cameraZoom > 256.0f) cameraZoom = 256.0f;
+
+    cameraX = (float)(worldX - ndcX / cameraZoom);
+    cameraY = (float)(worldY - ndcY / cameraZoom);
+}
 
+//Dropping an .rle file onto the window stamps the pattern into the paused board.
+static void drop_callback(GLFWwindow* window, int count, const char** paths)
+{
+    if (simulationRunning || count < 1) return;
+
+    if (simThread) simThread->beginBoardEdit();
+    if (loadRlePattern(paths[0], *simulation))
+    {
+        gpuStateDirty = true;
+    }
+    else
+    {
+        std::cout << "Couldn't load pattern: " << paths[0] << std::endl;
     }
+    if (simThread) simThread->endBoardEdit();
+}
+
+//Cell window visible under the current camera, clamped to the board. The
+//translation rebuild loops only walk these rows and columns, so drawing a
+//zoomed-in corner of a huge board costs the corner, not the board.
+static void visibleCellRange(int& rowBegin, int& rowEnd, int& colBegin, int& colEnd)
+{
+    float halfView = 1.0f / cameraZoom;
+
+    colBegin = (int)floor((cameraX - halfView - viewPortLeft) / gridSquareSize);
+    colEnd   = (int)ceil ((cameraX + halfView - viewPortLeft) / gridSquareSize);
+    rowBegin = (int)floor((cameraY - halfView - viewPortBottom) / gridSquareSize);
+    rowEnd   = (int)ceil ((cameraY + halfView - viewPortBottom) / gridSquareSize);
+
+    if (colBegin < 0) colBegin = 0;
+    if (rowBegin < 0) rowBegin = 0;
+    if (colEnd > boardSize) colEnd = boardSize;
+    if (rowEnd > boardSize) rowEnd = boardSize;
+}
+
+//Shader binary cache. The kiosk deployment restarts the app constantly, so
+//paying the driver's compile + link on every launch adds up; a program that
+//linked once gets its binary dumped next to the exe and later launches feed
+//it straight back with glProgramBinary. The cache is keyed on the driver
+//strings - a driver update or a GPU swap just makes it recompile and rewrite.
+//Needs GL 4.1 for the program binary calls (our glad loader only tracks core
+//versions); on a plain 3.3 context everything silently compiles like before.
+
+static bool readCachedString(FILE* file, const char* expected)
+{
+    std::uint32_t length = 0;
+    if (fread(&length, sizeof(length), 1, file) != 1) return false;
+    if (length != strlen(expected)) return false;
+
+    std::vector<char> stored(length);
+    if (length && fread(&stored[0], 1, length, file) != length) return false;
+    return memcmp(&stored[0], expected, length) == 0;
+}
+
+static void writeCachedString(FILE* file, const char* value)
+{
+    std::uint32_t length = (std::uint32_t)strlen(value);
+    fwrite(&length, sizeof(length), 1, file);
+    fwrite(value, 1, length, file);
+}
+
+static bool loadProgramBinary(const char* path, unsigned int program)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    char magic[4] = {};
+    bool headerOk = fread(magic, 1, 4, file) == 4 && memcmp(magic, "CSH1", 4) == 0
+        && readCachedString(file, (const char*)glGetString(GL_VENDOR))
+        && readCachedString(file, (const char*)glGetString(GL_RENDERER))
+        && readCachedString(file, (const char*)glGetString(GL_VERSION));
+
+    std::uint32_t format = 0;
+    std::uint32_t length = 0;
+    std::vector<unsigned char> blob;
+    if (headerOk
+        && fread(&format, sizeof(format), 1, file) == 1
+        && fread(&length, sizeof(length), 1, file) == 1
+        && length > 0)
+    {
+        blob.resize(length);
+        if (fread(&blob[0], 1, length, file) != length) blob.clear();
+    }
+    fclose(file);
+
+    if (blob.empty()) return false;
+
+    glProgramBinary(program, format, &blob[0], (GLsizei)blob.size());
+
+    int success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    return success != 0;
+}
+
+static void saveProgramBinary(const char* path, unsigned int program)
+{
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<unsigned char> blob(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, &blob[0]);
+    if (written <= 0) return;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return;
+
+    fwrite("CSH1", 1, 4, file);
+    writeCachedString(file, (const char*)glGetString(GL_VENDOR));
+    writeCachedString(file, (const char*)glGetString(GL_RENDERER));
+    writeCachedString(file, (const char*)glGetString(GL_VERSION));
+
+    std::uint32_t storedFormat = (std::uint32_t)format;
+    std::uint32_t storedLength = (std::uint32_t)written;
+    fwrite(&storedFormat, sizeof(storedFormat), 1, file);
+    fwrite(&storedLength, sizeof(storedLength), 1, file);
+    fwrite(&blob[0], 1, written, file);
+    fclose(file);
 }
 
 unsigned createShaderProgram(const char* vertexShaderCode, const char* fragmentShaderCode)
@@ -109,6 +757,13 @@ unsigned createShaderProgram(const char* vertexShaderCode, const char* fragmentS
 
     glAttachShader(shaderProgram, vertexShader);
     glAttachShader(shaderProgram, fragmentShader);
+
+    //Has to be set before the link or some drivers hand back nothing.
+    if (GLAD_GL_VERSION_4_1)
+    {
+        glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     glLinkProgram(shaderProgram);
 
     glDeleteShader(vertexShader);
@@ -124,6 +779,22 @@ unsigned createShaderProgram(const char* vertexShaderCode, const char* fragmentS
 	return shaderProgram;
 }
 
+//Cache-aware front end: tries the cached binary first, compiles and refreshes
+//the cache when that misses (first launch, driver change, stale file).
+unsigned createShaderProgramCached(const char* cachePath, const char* vertexShaderCode, const char* fragmentShaderCode)
+{
+    if (GLAD_GL_VERSION_4_1)
+    {
+        unsigned int program = glCreateProgram();
+        if (loadProgramBinary(cachePath, program)) return program;
+        glDeleteProgram(program);
+    }
+
+    unsigned int program = createShaderProgram(vertexShaderCode, fragmentShaderCode);
+    if (GLAD_GL_VERSION_4_1) saveProgramBinary(cachePath, program);
+    return program;
+}
+
 // There will be a single window, so we can handle the initialization in a single function.
 GLFWwindow* init()
 {
@@ -163,6 +834,9 @@ GLFWwindow* init()
     glfwSetKeyCallback(window, key_callback);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetCursorPosCallback(window, cursor_position_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetDropCallback(window, drop_callback);
     glfwSwapInterval(1);
     glViewport(0, 0, windowWidth, windowHeight);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -176,23 +850,20 @@ struct vec2
 	float y = 0.0f;
 };
 
-class Drawable
-{
-public:
-        virtual void draw(int translationLocation) = 0;
-};
-
-class Grid : public Drawable
+class Grid
 {
     std::vector<float> vertices;
-    unsigned int vbo;
-    unsigned int vao;
+    unsigned int vbo = 0;
+    unsigned int vao = 0;
 
-public:
-
-    Grid()
+    //Deferred from the constructor to the first draw: on a huge board the
+    //line vertices are a noticeable chunk of startup, and the first frame
+    //shouldn't wait for geometry it hasn't asked to draw yet.
+    void ensureBuffers()
     {
-        for (int i = 0; i < numberOfSeparators; i++)
+        if (this->vao) return;
+
+        for (int i = 0; i < boardSize; i++)
         {
             float x = viewPortLeft + gridSquareSize * i;
 
@@ -222,9 +893,13 @@ public:
         glEnableVertexAttribArray(0);
     }
 
+public:
+
     //I have a single shader, so I won't need to bind it.
     void draw(int translationLocation)
     {
+        this->ensureBuffers();
+
         glUniform2f(translationLocation, 0.0f, 0.0f);
 
         glBindVertexArray(this->vao);
@@ -233,7 +908,7 @@ public:
     }
 };
 
-class Squares : public Drawable
+class Squares
 {
     float vertices[12];
 
@@ -247,6 +922,63 @@ class Squares : public Drawable
     unsigned int vbo;
     unsigned int vao;
     unsigned int ebo;
+    unsigned int instanceVbo;
+
+    //Streaming state: the instance buffer holds three frame-sized regions
+    //written round-robin, so the CPU fills next frame's region while the GPU
+    //still reads the previous ones. A fence per region tells us when the GPU
+    //is done with it; by the time a region comes around again the fence has
+    //normally long been signaled, so the wait is the exception, not the rule.
+    static const int streamRegions = 3;
+    size_t regionCapacity = 0;           //instances per region
+    GLsync regionFence[streamRegions] = {};
+    int streamIndex = 0;
+
+    //With GL 4.4 / ARB_buffer_storage the whole buffer stays mapped
+    //persistently and coherently; on a plain 3.3 context we fall back to
+    //unsynchronized glMapBufferRange into the fenced regions.
+    bool persistentMapped = false;
+    unsigned char* persistentPtr = nullptr;
+
+    void waitRegion(int region)
+    {
+        if (!this->regionFence[region]) return;
+        glClientWaitSync(this->regionFence[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        glDeleteSync(this->regionFence[region]);
+        this->regionFence[region] = 0;
+    }
+
+    //(Re)allocates all three regions at the given per-region instance count.
+    //GL_ARRAY_BUFFER must be bound to instanceVbo.
+    void growStream(size_t instances)
+    {
+        for (int r = 0; r < streamRegions; r++) this->waitRegion(r);
+
+        this->regionCapacity = instances;
+        size_t bytes = streamRegions * instances * sizeof(vec2);
+
+        //Our glad loader only tracks core versions, so 4.4 is the check.
+        this->persistentMapped = GLAD_GL_VERSION_4_4 != 0;
+        if (this->persistentMapped)
+        {
+            //Immutable storage can't be resized, so growing means a new buffer.
+            glDeleteBuffers(1, &this->instanceVbo);
+            glGenBuffers(1, &this->instanceVbo);
+            glBindBuffer(GL_ARRAY_BUFFER, this->instanceVbo);
+            glBufferStorage(GL_ARRAY_BUFFER, bytes, NULL,
+                GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+            this->persistentPtr = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes,
+                GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+        }
+        else
+        {
+            glBufferData(GL_ARRAY_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+        }
+    }
+
+    bool incrementalMode = false;
+    std::vector<int> cellSlot;  //cell index -> slot in translations, -1 if dead
+    std::vector<int> slotCell;  //slot -> cell index
 
 public:
 
@@ -272,6 +1004,7 @@ public:
         glGenBuffers(1,         &this->vbo);
         glGenVertexArrays(1,    &this->vao);
         glGenBuffers(1,         &this->ebo);
+        glGenBuffers(1,         &this->instanceVbo);
 
         glBindVertexArray(this->vao);
         glBindBuffer(GL_ARRAY_BUFFER, this->vbo);
@@ -282,13 +1015,62 @@ public:
 
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
         glEnableVertexAttribArray(0);
+
+        //One translation per instance, advanced once per square instead of once per vertex.
+        glBindBuffer(GL_ARRAY_BUFFER, this->instanceVbo);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(vec2), (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribDivisor(1, 1);
     }
 
+    //clear() keeps the vector's capacity, so after the first frame a full
+    //rebuild does no allocations either.
     void clearTranslations()
     {
         this->translations.clear();
 	};
 
+    void reserveTranslations(size_t count)
+    {
+        this->translations.reserve(count);
+    }
+
+    //Incremental mode: the buffer is kept alive across frames and patched
+    //from the simulation's born/died deltas. One slot per live cell,
+    //swap-removed on death so the vector stays dense.
+    void beginIncremental(int cellCount)
+    {
+        this->incrementalMode = true;
+        this->cellSlot.assign(cellCount, -1);
+        this->slotCell.clear();
+        this->translations.clear();
+    }
+
+    void setCell(int cellIndex, bool alive, float x, float y)
+    {
+        int slot = this->cellSlot[cellIndex];
+
+        if (alive && slot < 0)
+        {
+            this->cellSlot[cellIndex] = (int)this->translations.size();
+            this->slotCell.push_back(cellIndex);
+            this->addTranslation(x, y);
+        }
+        else if (!alive && slot >= 0)
+        {
+            //Move the last live cell into the freed slot.
+            int lastSlot = (int)this->translations.size() - 1;
+            int movedCell = this->slotCell[lastSlot];
+            this->translations[slot] = this->translations[lastSlot];
+            this->slotCell[slot] = movedCell;
+            this->cellSlot[movedCell] = slot;
+
+            this->translations.pop_back();
+            this->slotCell.pop_back();
+            this->cellSlot[cellIndex] = -1;
+        }
+    }
+
     void addTranslation(float x, float y)
     {
         vec2 translation;
@@ -303,23 +1085,350 @@ public:
 	};
 
     //I have a single shader, so I won't need to bind it.
+    //All live cells go out in one instanced call instead of a uniform + draw per cell,
+    //which was by far our biggest frame-time cost on dense boards. The upload
+    //streams through the triple-buffered regions, so it never stalls on a
+    //buffer the GPU is still drawing from.
     void draw(int translationLocation)
     {
         if (translations.size() == 0) return;
 
+        glUniform2f(translationLocation, 0.0f, 0.0f);
+
+        glBindBuffer(GL_ARRAY_BUFFER, this->instanceVbo);
+        if (translations.size() > this->regionCapacity) this->growStream(translations.size());
+
+        this->streamIndex = (this->streamIndex + 1) % streamRegions;
+        size_t offsetBytes = (size_t)this->streamIndex * this->regionCapacity * sizeof(vec2);
+        size_t bytes = translations.size() * sizeof(vec2);
+
+        this->waitRegion(this->streamIndex);
+
+        if (this->persistentMapped)
+        {
+            //Coherent mapping: a plain memcpy, the driver sees it as-is.
+            memcpy(this->persistentPtr + offsetBytes, &this->translations[0], bytes);
+        }
+        else
+        {
+            //Unsynchronized is safe here because the fence told us the GPU
+            //has vacated this region.
+            void* dst = glMapBufferRange(GL_ARRAY_BUFFER, offsetBytes, bytes,
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+            memcpy(dst, &this->translations[0], bytes);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
 
         glBindVertexArray(this->vao);
-        for (int i = 0; i < translations.size(); i++)
+
+        //Point the instance attribute at this frame's region.
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(vec2), (void*)offsetBytes);
+
+        glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (int)translations.size());
+
+        this->regionFence[this->streamIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glBindVertexArray(0);
+    }
+};
+
+//GPU-resident backend: the grid lives in a pair of R8 textures and a
+//generation is one ping-pong fragment pass, so large boards neither burn CPU
+//on the update nor upload live-cell translations every frame. The CPU-side
+//Simulation stays the editing master; state moves across only on pause/edit.
+class GpuLife
+{
+    int size;
+    unsigned int textures[2];
+    unsigned int fbos[2];
+    int current = 0;
+    unsigned int stepProgram;
+    unsigned int displayProgram;
+    unsigned int emptyVao;
+    int stepStateLocation;
+    int displayStateLocation;
+    int viewSizeLocation;
+    int camOffsetLocation;
+    int camScaleLocation;
+    std::vector<unsigned char> transferBuffer;
+
+public:
+
+    GpuLife(int size) : size(size), transferBuffer((size_t)size * size)
+    {
+        //The board is runtime-sized and the transfer buffer tightly packed;
+        //GL defaults both row alignments to 4, which on any size not
+        //divisible by 4 skews the rows and reads/writes past the buffer.
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+        glGenTextures(2, this->textures);
+        glGenFramebuffers(2, this->fbos);
+
+        for (int i = 0; i < 2; i++)
+        {
+            glBindTexture(GL_TEXTURE_2D, this->textures[i]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, size, size, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, this->fbos[i]);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->textures[i], 0);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        this->stepProgram = createShaderProgramCached("lifestep.shaderbin", fullscreenVertexShaderSource, lifeStepFragmentShaderSource);
+        this->displayProgram = createShaderProgramCached("display.shaderbin", fullscreenVertexShaderSource, boardDisplayFragmentShaderSource);
+        this->stepStateLocation = glGetUniformLocation(this->stepProgram, "state");
+        this->displayStateLocation = glGetUniformLocation(this->displayProgram, "state");
+        this->viewSizeLocation = glGetUniformLocation(this->displayProgram, "viewSize");
+        this->camOffsetLocation = glGetUniformLocation(this->displayProgram, "camOffset");
+        this->camScaleLocation = glGetUniformLocation(this->displayProgram, "camScale");
+
+        //Core profile refuses to draw without a VAO, even an attribute-less one.
+        glGenVertexArrays(1, &this->emptyVao);
+    }
+
+    void upload(const Simulation& sim)
+    {
+        for (int i = 0; i < this->size; i++)
+        {
+            for (int j = 0; j < this->size; j++)
+            {
+                this->transferBuffer[(size_t)i * this->size + j] = sim.isAlive(i, j) ? 255 : 0;
+            }
+        }
+
+        glBindTexture(GL_TEXTURE_2D, this->textures[this->current]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->size, this->size, GL_RED, GL_UNSIGNED_BYTE, &this->transferBuffer[0]);
+    }
+
+    void download(Simulation& sim)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, this->fbos[this->current]);
+        glReadPixels(0, 0, this->size, this->size, GL_RED, GL_UNSIGNED_BYTE, &this->transferBuffer[0]);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        for (int i = 0; i < this->size; i++)
+        {
+            for (int j = 0; j < this->size; j++)
+            {
+                sim.setAlive(i, j, this->transferBuffer[(size_t)i * this->size + j] != 0);
+            }
+        }
+    }
+
+    //One generation: render the rule into the other texture and swap.
+    void step()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, this->fbos[1 - this->current]);
+        glViewport(0, 0, this->size, this->size);
+
+        glUseProgram(this->stepProgram);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, this->textures[this->current]);
+        glUniform1i(this->stepStateLocation, 0);
+
+        glBindVertexArray(this->emptyVao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        this->current = 1 - this->current;
+    }
+
+    //Draws the whole board straight from the GPU-resident state.
+    void drawBoard(int viewWidth, int viewHeight)
+    {
+        glViewport(0, 0, viewWidth, viewHeight);
+
+        glUseProgram(this->displayProgram);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, this->textures[this->current]);
+        glUniform1i(this->displayStateLocation, 0);
+        glUniform2f(this->viewSizeLocation, (float)viewWidth, (float)viewHeight);
+        glUniform2f(this->camOffsetLocation, cameraX, cameraY);
+        glUniform1f(this->camScaleLocation, cameraZoom);
+
+        glBindVertexArray(this->emptyVao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+    }
+};
+
+//Dense-board renderer: the whole grid goes up as one R8 texture and a single
+//fullscreen pass samples it, so draw cost is constant in population and board
+//size - on a half-alive 1024x1024 board Squares pushes half a million quads,
+//this pushes one triangle. Squares stays the choice for small boards where
+//crisp per-cell geometry matters.
+class TextureBoard
+{
+    int size;
+    unsigned int texture;
+    unsigned int displayProgram;
+    unsigned int emptyVao;
+    int stateLocation;
+    int viewSizeLocation;
+    int camOffsetLocation;
+    int camScaleLocation;
+    std::vector<unsigned char> transferBuffer;
+
+public:
+
+    TextureBoard(int size) : size(size), transferBuffer((size_t)size * size)
+    {
+        //Same story as GpuLife: tightly packed rows at a runtime size, so
+        //the default 4-byte row alignment must go.
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        glGenTextures(1, &this->texture);
+        glBindTexture(GL_TEXTURE_2D, this->texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, size, size, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        this->displayProgram = createShaderProgramCached("display.shaderbin", fullscreenVertexShaderSource, boardDisplayFragmentShaderSource);
+        this->stateLocation = glGetUniformLocation(this->displayProgram, "state");
+        this->viewSizeLocation = glGetUniformLocation(this->displayProgram, "viewSize");
+        this->camOffsetLocation = glGetUniformLocation(this->displayProgram, "camOffset");
+        this->camScaleLocation = glGetUniformLocation(this->displayProgram, "camScale");
+
+        glGenVertexArrays(1, &this->emptyVao);
+    }
+
+    //Refreshes the texture from the CPU grid; one linear pass and one upload,
+    //independent of how many cells are alive.
+    void upload(const Simulation& sim)
+    {
+        for (int i = 0; i < this->size; i++)
+        {
+            for (int j = 0; j < this->size; j++)
+            {
+                this->transferBuffer[(size_t)i * this->size + j] = sim.isAlive(i, j) ? 255 : 0;
+            }
+        }
+
+        glBindTexture(GL_TEXTURE_2D, this->texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->size, this->size, GL_RED, GL_UNSIGNED_BYTE, &this->transferBuffer[0]);
+    }
+
+    //Same refresh, but from a linear 0/1 snapshot published by the simulation
+    //thread, so the running Simulation is never touched from this thread.
+    void upload(const std::uint8_t* cells)
+    {
+        for (size_t n = 0; n < this->transferBuffer.size(); n++)
         {
-            glUniform2f(translationLocation, translations[i].x, translations[i].y);
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+            this->transferBuffer[n] = cells[n] ? 255 : 0;
         }
+
+        glBindTexture(GL_TEXTURE_2D, this->texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->size, this->size, GL_RED, GL_UNSIGNED_BYTE, &this->transferBuffer[0]);
+    }
+
+    void drawBoard(int viewWidth, int viewHeight)
+    {
+        glViewport(0, 0, viewWidth, viewHeight);
+
+        glUseProgram(this->displayProgram);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, this->texture);
+        glUniform1i(this->stateLocation, 0);
+        glUniform2f(this->viewSizeLocation, (float)viewWidth, (float)viewHeight);
+        glUniform2f(this->camOffsetLocation, cameraX, cameraY);
+        glUniform1f(this->camScaleLocation, cameraZoom);
+
+        glBindVertexArray(this->emptyVao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
         glBindVertexArray(0);
     }
 };
 
-int main(void)
+int main(int argc, char* argv[])
 {
+    if (argc > 1 && argv[1][0] != '-')
+    {
+        boardSize = atoi(argv[1]);
+        if (boardSize <= 0)
+        {
+            std::cout << "Invalid board size: " << argv[1] << std::endl;
+            return -1;
+        }
+        gridSquareSize = viewPortSize / boardSize;
+    }
+
+    //--restore sizes the board from the snapshot header, so it has to be
+    //picked up before the Simulation is constructed.
+    const char* restorePath = nullptr;
+    for (int i = 1; i < argc - 1; i++)
+    {
+        if (std::string(argv[i]) == "--restore") restorePath = argv[i + 1];
+    }
+    if (restorePath)
+    {
+        int snapshotSize = snapshotBoardSize(restorePath);
+        if (snapshotSize <= 0)
+        {
+            std::cout << "Couldn't read snapshot: " << restorePath << std::endl;
+            return -1;
+        }
+        boardSize = snapshotSize;
+        gridSquareSize = viewPortSize / boardSize;
+    }
+
+    Simulation sim(boardSize);
+    simulation = &sim;
+
+    //Widest kernel the CPU supports by default; --scalar and --bits override.
+    sim.setKernel(Simulation::detectKernel());
+
+    bool gpuMode = false;
+    bool textureMode = false;
+    int historyCapacity = 256;
+    const char* statsCsvPath = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--gpu") gpuMode = true;
+        else if (std::string(argv[i]) == "--texture") textureMode = true;
+        else if (std::string(argv[i]) == "--bits") sim.setKernel(Kernel::Bitwise);
+        else if (std::string(argv[i]) == "--scalar") sim.setKernel(Kernel::Scalar);
+        else if (std::string(argv[i]) == "--incremental") sim.setIncremental(true);
+        else if (std::string(argv[i]) == "--torus") sim.setTopology(Topology::Torus);
+        else if (std::string(argv[i]) == "--threads" && i + 1 < argc)
+        {
+            sim.setThreadCount(atoi(argv[++i]));
+        }
+        else if (std::string(argv[i]) == "--gps" && i + 1 < argc)
+        {
+            generationsPerSecond = atof(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--pattern" && i + 1 < argc)
+        {
+            if (!loadRlePattern(argv[++i], sim))
+            {
+                std::cout << "Couldn't load pattern: " << argv[i] << std::endl;
+                return -1;
+            }
+        }
+        else if (std::string(argv[i]) == "--restore" && i + 1 < argc)
+        {
+            i++;    //handled above, before the Simulation existed
+        }
+        else if (std::string(argv[i]) == "--history" && i + 1 < argc)
+        {
+            historyCapacity = atoi(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--stats-csv" && i + 1 < argc)
+        {
+            statsCsvPath = argv[++i];
+        }
+    }
+
+    if (restorePath && !loadSnapshot(restorePath, sim)) return -1;
+
 	GLFWwindow* window = init();
 
     if (!window) return -1;
@@ -328,7 +1437,7 @@ int main(void)
 
     try
     {
-        shaderProgram = createShaderProgram(vertexShaderSource, fragmentShaderSource);
+        shaderProgram = createShaderProgramCached("cell.shaderbin", vertexShaderSource, fragmentShaderSource);
     }
     catch (int e)
     {
@@ -338,16 +1447,107 @@ int main(void)
 	Grid grid;
 	Squares square;
 
-	std::vector<Drawable*> drawables;
+    //Compile-time render list: each draw call below is statically bound (and
+    //inlinable) instead of going through a virtual on a pointer vector.
+    auto drawables = std::tie(grid, square);
 
-	drawables.push_back(&grid);
-	drawables.push_back(&square);
+    //With an incremental simulation the translation buffer is patched from
+    //the changed-cell deltas instead of being rebuilt by a full-grid scan.
+    //The texture renderer has no translation buffer to keep in sync.
+    bool deltaRender = sim.isIncremental() && !textureMode;
+    if (deltaRender) square.beginIncremental(boardSize * boardSize);
 
-    int translationLocation = glGetUniformLocation(shaderProgram, "trans");
+    GpuLife* gpu = nullptr;
+    TextureBoard* texBoard = nullptr;
+    if (gpuMode)
+    {
+        try
+        {
+            gpu = new GpuLife(boardSize);
+        }
+        catch (int e)
+        {
+            return e;
+        }
+        gpu->upload(sim);
+    }
+    else if (textureMode)
+    {
+        try
+        {
+            texBoard = new TextureBoard(boardSize);
+        }
+        catch (int e)
+        {
+            return e;
+        }
+    }
+
+    //The rewind ring records on the simulation thread (inside its lock) and
+    //is only rewound while paused, so the two never race. The GPU backend
+    //steps without the CPU grid ever seeing the generations, so no history.
+    if (!gpuMode && historyCapacity > 0)
+    {
+        history = new History(historyCapacity);
+        history->record(sim);
+    }
+
+    //Every CPU engine steps on the dedicated simulation thread from here on;
+    //this thread only consumes what it publishes. It starts parked and gets
+    //woken/parked by the SPACE handler.
+    if (!gpuMode) simThread = new SimThread(sim);
+
+    auto applyCellDeltas = [&]()
+    {
+        const std::vector<int>& changed = sim.getChangedCells();
+        for (size_t n = 0; n < changed.size(); n++)
+        {
+            int idx = changed[n];
+            int i = idx / boardSize;
+            int j = idx % boardSize;
+            square.setCell(idx, sim.isAlive(i, j),
+                           viewPortLeft + gridSquareSize * j,
+                           viewPortBottom + gridSquareSize * i);
+        }
+    };
+
+    FrameStats frameStats;
+    if (statsCsvPath && !frameStats.openCsv(statsCsvPath))
+    {
+        std::cout << "Couldn't open stats CSV: " << statsCsvPath << std::endl;
+        return -1;
+    }
+
+    //Simulation time accrued since the last rendered frame; several
+    //generations can run per frame, so it is accumulated, not sampled.
+    double simSeconds = 0;
 
-    constexpr double fpsLimit = 1.0 / 15.0;
-    double lastUpdateTime = 0;  // number of seconds since the last loop
-    double lastFrameTime = 0;   // number of seconds since the last frame
+    //GPU generations only; the CPU engines step on the simulation thread.
+    auto runGeneration = [&]()
+    {
+        double t0 = glfwGetTime();
+        gpu->step();
+        simSeconds += glfwGetTime() - t0;
+    };
+
+    int translationLocation = glGetUniformLocation(shaderProgram, "trans");
+    int camOffsetLocation = glGetUniformLocation(shaderProgram, "camOffset");
+    int camScaleLocation = glGetUniformLocation(shaderProgram, "camScale");
+
+    //The slot acquire() hands out stays valid until the next acquire, so the
+    //translations can be rebuilt from the last published generation when only
+    //the camera moved.
+    const std::vector<std::uint8_t>* lastPublished = nullptr;
+    float lastCameraX = cameraX;
+    float lastCameraY = cameraY;
+    float lastCameraZoom = cameraZoom;
+
+    constexpr double fpsLimit = 1.0 / 60.0;
+    double lastUpdateTime = glfwGetTime();  // time of the last simulation pass
+    double lastFrameTime = 0;               // time of the last rendered frame
+    double lastStatsTime = 0;               // time of the last stats readout
+    double updateAccumulator = 0;
+    bool wasRunning = false;
 
     /* Loop until the user closes the window */
     while (!glfwWindowShouldClose(window))
@@ -355,89 +1555,262 @@ int main(void)
 
         double now = glfwGetTime();
 
-        if ((now - lastFrameTime) >= fpsLimit)
+        //HashLife fast-forward: jump the paused board ahead in one memoized
+        //sweep instead of grinding generations one by one.
+        if (fastForwardGenerations > 0 && !simulationRunning)
         {
-            /* Render here */
-            glClear(GL_COLOR_BUFFER_BIT);
+            if (simThread) simThread->beginBoardEdit();
+
+            HashLife hashLife(boardSize);
+            hashLife.loadFrom(sim);
+            hashLife.run(fastForwardGenerations);
+            hashLife.writeTo(sim);
+            //writeTo only copies cells; advance the counter too so the
+            //history delta and snapshot headers carry the right generation.
+            sim.setGeneration(sim.getGeneration() + hashLife.getGeneration());
+            fastForwardGenerations = 0;
+            gpuStateDirty = true;
+
+            //One (possibly large) delta; R undoes the whole jump at once.
+            if (history) history->record(sim);
+
+            if (simThread) simThread->endBoardEdit();
+        }
 
-            //Conways Game of Life logic
-            if (simulationRunning)
+        //The CPU-side Simulation stays the editing master: pull the GPU state
+        //down when pausing, push it back up after edits.
+        if (gpu)
+        {
+            if (wasRunning && !simulationRunning) gpu->download(sim);
+            if (gpuStateDirty && !simulationRunning)
             {
-                bool newMapGrid[numberOfSeparators][numberOfSeparators] = { false };
-                for (int i = 0; i < numberOfSeparators; i++)
+                gpu->upload(sim);
+                gpuStateDirty = false;
+            }
+        }
+        //Pausing hands rendering back to the delta path, but the
+        //published-snapshot rebuilds below trampled the slot bookkeeping, so
+        //reseed it from the (now safely idle) simulation.
+        if (wasRunning && !simulationRunning && deltaRender && simThread)
+        {
+            square.beginIncremental(boardSize * boardSize);
+            for (int i = 0; i < boardSize; i++)
+            {
+                for (int j = 0; j < boardSize; j++)
                 {
-                    for (int j = 0; j < numberOfSeparators; j++)
+                    if (sim.isAlive(i, j))
                     {
-                        int aliveNeighbours = 0;
+                        square.setCell(i * boardSize + j, true,
+                                       viewPortLeft + gridSquareSize * j,
+                                       viewPortBottom + gridSquareSize * i);
+                    }
+                }
+            }
+        }
+        wasRunning = simulationRunning;
 
-                        //Check 8 neighbourhood
-                        for (int x = -1; x <= 1; x++)
-                        {
-                            if (i + x < 0 || i + x >= numberOfSeparators) continue;
+        //Conways Game of Life logic, on its own clock: the accumulator runs
+        //as many generations as the elapsed time owes us, independent of how
+        //often we render. Only the GPU backend still steps here - its
+        //generations are GL calls and have to stay on the context thread.
+        if (simulationRunning && gpu)
+        {
+            if (generationsPerSecond <= 0.0)
+            {
+                //Unlimited: simulate flat out until the next frame is due.
+                do
+                {
+                    runGeneration();
+                } while (glfwGetTime() - lastFrameTime < fpsLimit);
+            }
+            else
+            {
+                updateAccumulator += now - lastUpdateTime;
 
-                            for (int y = -1; y <= 1; y++)
-                            {
-                                if (j + y < 0 || j + y >= numberOfSeparators) continue;
-                                if (x == 0 && y == 0) continue;
+                //Don't spiral if a generation takes longer than its budget.
+                double maxBacklog = 4.0 / generationsPerSecond;
+                if (updateAccumulator > maxBacklog) updateAccumulator = maxBacklog;
 
-                                if (mapGrid[i + x][j + y]) aliveNeighbours++;
-                            }
-                        }
+                double step = 1.0 / generationsPerSecond;
+                while (updateAccumulator >= step)
+                {
+                    runGeneration();
+                    updateAccumulator -= step;
+                }
+            }
+        }
+        lastUpdateTime = now;
 
-                        if (mapGrid[i][j] && (aliveNeighbours < 2 || aliveNeighbours > 3)) newMapGrid[i][j] = false;
-                        else if (!mapGrid[i][j] && aliveNeighbours == 3) newMapGrid[i][j] = true;
-                        else
-                        {
-							newMapGrid[i][j] = mapGrid[i][j];
-                        }
-                    }
+        if ((now - lastFrameTime) >= fpsLimit)
+        {
+            /* Render here */
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            bool cameraMoved = cameraX != lastCameraX || cameraY != lastCameraY ||
+                               cameraZoom != lastCameraZoom;
+            lastCameraX = cameraX;
+            lastCameraY = cameraY;
+            lastCameraZoom = cameraZoom;
+
+            double rebuildStart = glfwGetTime();
+
+            if (gpu)
+            {
+                //Cells never leave the GPU; nothing to prepare.
+            }
+            else if (texBoard)
+            {
+                //One linear upload, no per-cell geometry. While running it
+                //comes from the published snapshot, not the live Simulation.
+                if (simThread && simulationRunning)
+                {
+                    const std::vector<std::uint8_t>* published = simThread->acquire();
+                    if (published) texBoard->upload(&(*published)[0]);
                 }
+                else
+                {
+                    texBoard->upload(sim);
+                }
+            }
+            else if (simThread && simulationRunning)
+            {
+                //Latest generation the simulation thread published; if
+                //nothing new arrived (and the camera held still) we keep
+                //drawing last frame's. Only the visible window is walked.
+                const std::vector<std::uint8_t>* published = simThread->acquire();
+                if (published) lastPublished = published;
 
-                for(int i = 0; i < numberOfSeparators; i++)
+                if (lastPublished && (published || cameraMoved))
                 {
-                    for (int j = 0; j < numberOfSeparators; j++)
+                    int rowBegin, rowEnd, colBegin, colEnd;
+                    visibleCellRange(rowBegin, rowEnd, colBegin, colEnd);
+
+                    square.clearTranslations();
+                    for (int i = rowBegin; i < rowEnd; i++)
                     {
-                        mapGrid[i][j] = newMapGrid[i][j];
+                        for (int j = colBegin; j < colEnd; j++)
+                        {
+                            if ((*lastPublished)[(size_t)i * boardSize + j])
+                            {
+                                float x = viewPortLeft + gridSquareSize * j;
+                                float y = viewPortBottom + gridSquareSize * i;
+                                square.addTranslation(x, y);
+                            }
+                        }
                     }
-				}
+                }
             }
-
-            //Ugly, but it works.
-            square.clearTranslations();
-            for (int i = 0; i < numberOfSeparators; i++)
+            else if (deltaRender)
             {
-                for (int j = 0; j < numberOfSeparators; j++)
+                //Covers edits made while paused; a no-op otherwise. The
+                //buffer holds the whole board, so the camera needs no rescan
+                //here - offscreen cells are clipped by the vertex transform.
+                applyCellDeltas();
+            }
+            else
+            {
+                //Ugly, but it works. At least it only walks the rows and
+                //columns the camera can actually see.
+                int rowBegin, rowEnd, colBegin, colEnd;
+                visibleCellRange(rowBegin, rowEnd, colBegin, colEnd);
+
+                square.clearTranslations();
+                for (int i = rowBegin; i < rowEnd; i++)
                 {
-                    if (mapGrid[i][j])
+                    for (int j = colBegin; j < colEnd; j++)
                     {
-                        float x = viewPortLeft + gridSquareSize * j;
-                        float y = viewPortBottom + gridSquareSize * i;
-                        square.addTranslation(x, y);
+                        if (sim.isAlive(i, j))
+                        {
+                            float x = viewPortLeft + gridSquareSize * j;
+                            float y = viewPortBottom + gridSquareSize * i;
+                            square.addTranslation(x, y);
+                        }
                     }
                 }
             }
 
-            glUseProgram(shaderProgram);
+            double drawStart = glfwGetTime();
+
+            if (gpu)
+            {
+                gpu->drawBoard(windowWidth, windowHeight);
+
+                glUseProgram(shaderProgram);
+                glUniform2f(camOffsetLocation, cameraX, cameraY);
+                glUniform1f(camScaleLocation, cameraZoom);
+                grid.draw(translationLocation);
+            }
+            else if (texBoard)
+            {
+                texBoard->drawBoard(windowWidth, windowHeight);
 
-            for (int i = 0; i < drawables.size(); i++)
+                glUseProgram(shaderProgram);
+                glUniform2f(camOffsetLocation, cameraX, cameraY);
+                glUniform1f(camScaleLocation, cameraZoom);
+                grid.draw(translationLocation);
+            }
+            else
             {
-				drawables[i]->draw(translationLocation);
+                glUseProgram(shaderProgram);
+                glUniform2f(camOffsetLocation, cameraX, cameraY);
+                glUniform1f(camScaleLocation, cameraZoom);
+
+                std::apply([&](auto&... drawable)
+                {
+                    (drawable.draw(translationLocation), ...);
+                }, drawables);
             }
 
+            double swapStart = glfwGetTime();
 
             /* Swap front and back buffers */
             glfwSwapBuffers(window);
 
+            double swapEnd = glfwGetTime();
+
+            if (simThread) simSeconds += simThread->takeSimSeconds();
+
+            double phaseSeconds[FrameStats::PhaseCount] =
+            {
+                simSeconds,
+                drawStart - rebuildStart,
+                swapStart - drawStart,
+                swapEnd - swapStart
+            };
+            frameStats.addFrame(phaseSeconds);
+            simSeconds = 0;
+
+            if (statsVisible && now - lastStatsTime >= 1.0)
+            {
+                std::string readout = frameStats.summary();
+                glfwSetWindowTitle(window, readout.c_str());
+                std::cout << readout << std::endl;
+                lastStatsTime = now;
+            }
+
             /* Poll for and process events */
             glfwPollEvents();
 
             lastFrameTime = now;
         }
-
-        lastUpdateTime = now;
+        else
+        {
+            //Nothing rendered this pass; still service the event queue.
+            glfwPollEvents();
+        }
 
     }
 
+    //Joins the simulation thread before the Simulation goes out of scope.
+    delete simThread;
+    simThread = nullptr;
+
+    delete history;
+    history = nullptr;
+
+    delete gpu;
+    delete texBoard;
+
     glfwTerminate();
     return 0;
 }
@@ -0,0 +1,472 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "Psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "HashLife.h"
+#include "RleLoader.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "SparseWorld.h"
+
+//Console benchmark and batch runner: runs the engine headless, so simulation
+//throughput can be measured on CI boxes with no GPU or display, and parameter
+//sweeps can grind thousands of configurations unattended (no window, no frame
+//pacing, no vsync - bounded only by CPU). Never touches GLFW or OpenGL.
+//
+//Usage: ConwayBench [size] [generations] [--scalar|--bits|--hashlife|--sparse] [--fused K] [--threads N] [--incremental] [--torus] [--pattern file.rle]
+//                   [--restore snap.bin] [--populations out.csv] [--snapshot out.bin]
+//       ConwayBench --suite out.json [--baseline prev.json] [--tolerance pct]
+//
+//--suite runs the fixed corpus (R-pentomino, Acorn, Gosper gun, random soups
+//at several densities and sizes) across every engine and writes one JSON
+//record per run, so releases can be charted against each other. --baseline
+//compares generations/sec against a previous suite file and fails the
+//process when any run regressed by more than the tolerance (default 10%).
+
+static void fillRandom(Simulation& sim, unsigned int seed)
+{
+    srand(seed);
+    for (int i = 0; i < sim.getSize(); i++)
+    {
+        for (int j = 0; j < sim.getSize(); j++)
+        {
+            sim.setAlive(i, j, rand() % 4 == 0);
+        }
+    }
+}
+
+//Soup at a given live-cell percentage, for the suite's density sweep.
+static void fillSoup(Simulation& sim, unsigned int seed, int densityPercent)
+{
+    srand(seed);
+    for (int i = 0; i < sim.getSize(); i++)
+    {
+        for (int j = 0; j < sim.getSize(); j++)
+        {
+            sim.setAlive(i, j, rand() % 100 < densityPercent);
+        }
+    }
+}
+
+//Peak resident set of the whole process so far. The OS only tracks the
+//high-water mark, so within one suite run the numbers are monotonic; the
+//per-run value still shows which engine pushed the peak where it is.
+static size_t peakRssBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+static const char* kernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::Scalar:  return "scalar";
+    case Kernel::Simd:    return "simd";
+    case Kernel::Bitwise: return "bitwise";
+    }
+    return "?";
+}
+
+//---- benchmark suite ---------------------------------------------------
+
+//The corpus lives in the binary, so the suite runs the same inputs on every
+//machine with no files to ship around.
+struct SuitePattern
+{
+    const char* name;
+    const char* rle;        //null means a random soup at the given density
+    int density;            //live-cell percent, soups only
+    int board;
+    int generations;
+};
+
+static const SuitePattern suiteCorpus[] =
+{
+    { "r-pentomino", "x = 3, y = 3\nb2o$2o$bo!",        0,  256, 1000 },
+    { "acorn",       "x = 7, y = 3\nbo$3bo$2o2b3o!",    0,  256, 1000 },
+    { "gosper-gun",  "x = 36, y = 9\n"
+      "24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b2o12b2o$2o8bo5bo3b2o$2o8bo3bob2o"
+      "4bobo$10bo5bo7bo$11bo3bo$12b2o!",                0,  256, 1000 },
+    { "soup-10",     nullptr,                          10,  256, 1000 },
+    { "soup-30",     nullptr,                          30,  256, 1000 },
+    { "soup-50",     nullptr,                          50,  256, 1000 },
+    { "soup-30-1k",  nullptr,                          30, 1024,  200 },
+};
+
+struct SuiteEngine
+{
+    const char* name;
+    Kernel kernel;
+    int threads;
+    bool hashLife;
+    int fusedSteps;
+};
+
+//Digs the recorded generations/sec for a run id out of a previous suite
+//file. We wrote that JSON ourselves, so a plain text scan is enough - no
+//parser dependency for the one number we need.
+static bool baselineGps(const std::string& baseline, const std::string& id, double& gps)
+{
+    std::string needle = "\"id\": \"" + id + "\"";
+    size_t at = baseline.find(needle);
+    if (at == std::string::npos) return false;
+
+    const char* key = "\"generations_per_sec\": ";
+    at = baseline.find(key, at);
+    if (at == std::string::npos) return false;
+
+    gps = atof(baseline.c_str() + at + strlen(key));
+    return true;
+}
+
+static int runSuite(const char* outPath, const char* baselinePath, double tolerancePercent)
+{
+    std::string baseline;
+    if (baselinePath)
+    {
+        FILE* file = fopen(baselinePath, "rb");
+        if (!file)
+        {
+            std::cout << "Couldn't read baseline: " << baselinePath << std::endl;
+            return -1;
+        }
+        char chunk[4096];
+        size_t got;
+        while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) baseline.append(chunk, got);
+        fclose(file);
+    }
+
+    FILE* out = fopen(outPath, "w");
+    if (!out)
+    {
+        std::cout << "Couldn't open suite output: " << outPath << std::endl;
+        return -1;
+    }
+
+    int hwThreads = (int)std::thread::hardware_concurrency();
+    if (hwThreads < 2) hwThreads = 2;
+
+    std::vector<SuiteEngine> engines;
+    engines.push_back({ "scalar", Kernel::Scalar, 1, false, 1 });
+    if (Simulation::detectKernel() == Kernel::Simd)
+    {
+        engines.push_back({ "simd", Kernel::Simd, 1, false, 1 });
+        engines.push_back({ "simd-mt", Kernel::Simd, hwThreads, false, 1 });
+    }
+    engines.push_back({ "bitwise", Kernel::Bitwise, 1, false, 1 });
+    engines.push_back({ "bitwise-fused4", Kernel::Bitwise, 1, false, 4 });
+    engines.push_back({ "hashlife", Kernel::Scalar, 1, true, 1 });
+
+    fprintf(out, "{\n  \"runs\": [\n");
+
+    int regressions = 0;
+    bool firstRecord = true;
+
+    for (size_t e = 0; e < engines.size(); e++)
+    {
+        const SuiteEngine& engine = engines[e];
+
+        for (size_t c = 0; c < sizeof(suiteCorpus) / sizeof(suiteCorpus[0]); c++)
+        {
+            const SuitePattern& pattern = suiteCorpus[c];
+
+            //HashLife memoizes repetition and a soup has none; feeding it one
+            //just burns memory, so it only runs the pattern corpus.
+            if (engine.hashLife && !pattern.rle) continue;
+
+            Simulation sim(pattern.board);
+            sim.setKernel(engine.kernel);
+            sim.setThreadCount(engine.threads);
+            sim.setFusedSteps(engine.fusedSteps);
+
+            if (pattern.rle) loadRleString(pattern.rle, sim);
+            else fillSoup(sim, 1234, pattern.density);
+
+            int generationsRun = pattern.generations;
+
+            auto start = std::chrono::steady_clock::now();
+
+            if (engine.hashLife)
+            {
+                HashLife hashLife(pattern.board);
+                hashLife.loadFrom(sim);
+                hashLife.run(pattern.generations);
+                hashLife.writeTo(sim);
+            }
+            else
+            {
+                //A fused update advances several generations at once; when K
+                //doesn't divide the count the last update overshoots, so the
+                //rates are computed from what actually ran.
+                int updates = (pattern.generations + engine.fusedSteps - 1) / engine.fusedSteps;
+                for (int u = 0; u < updates; u++) sim.update();
+                generationsRun = updates * engine.fusedSteps;
+            }
+
+            auto end = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            double gps = generationsRun / seconds;
+            double cups = gps * pattern.board * pattern.board;
+
+            std::string id = std::string(pattern.name) + "/" + engine.name;
+
+            if (!firstRecord) fprintf(out, ",\n");
+            firstRecord = false;
+            fprintf(out,
+                "    {\n"
+                "      \"id\": \"%s\",\n"
+                "      \"pattern\": \"%s\",\n"
+                "      \"engine\": \"%s\",\n"
+                "      \"threads\": %d,\n"
+                "      \"board\": %d,\n"
+                "      \"generations\": %d,\n"
+                "      \"seconds\": %.6f,\n"
+                "      \"generations_per_sec\": %.2f,\n"
+                "      \"cell_updates_per_sec\": %.0f,\n"
+                "      \"population\": %llu,\n"
+                "      \"peak_rss_bytes\": %llu\n"
+                "    }",
+                id.c_str(), pattern.name, engine.name, engine.threads,
+                pattern.board, generationsRun, seconds, gps, cups,
+                (unsigned long long)sim.getPopulation(),
+                (unsigned long long)peakRssBytes());
+
+            std::cout << id << ": " << gps << " generations/sec, population "
+                      << sim.getPopulation() << std::endl;
+
+            double previous;
+            if (baselinePath && baselineGps(baseline, id, previous)
+                && gps < previous * (1.0 - tolerancePercent / 100.0))
+            {
+                std::cout << "REGRESSION " << id << ": " << gps << " < "
+                          << previous << " - " << tolerancePercent << "%" << std::endl;
+                regressions++;
+            }
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    fclose(out);
+
+    if (regressions)
+    {
+        std::cout << regressions << " run(s) regressed past the threshold" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    int size = 1024;
+    int generations = 1000;
+
+    //Suite mode replaces the single-run flow entirely.
+    const char* suitePath = nullptr;
+    const char* baselinePath = nullptr;
+    double tolerancePercent = 10.0;
+    for (int i = 1; i < argc - 1; i++)
+    {
+        if (std::string(argv[i]) == "--suite") suitePath = argv[i + 1];
+        else if (std::string(argv[i]) == "--baseline") baselinePath = argv[i + 1];
+        else if (std::string(argv[i]) == "--tolerance") tolerancePercent = atof(argv[i + 1]);
+    }
+    if (suitePath) return runSuite(suitePath, baselinePath, tolerancePercent);
+
+    if (argc > 1 && argv[1][0] != '-') size = atoi(argv[1]);
+    if (argc > 2 && argv[2][0] != '-') generations = atoi(argv[2]);
+
+    if (size <= 0 || generations <= 0)
+    {
+        std::cout << "Usage: ConwayBench [size] [generations] [--scalar|--bits] [--threads N] [--incremental]" << std::endl;
+        return -1;
+    }
+
+    //--restore sizes the board from the snapshot header, like the app does.
+    const char* restorePath = nullptr;
+    for (int i = 1; i < argc - 1; i++)
+    {
+        if (std::string(argv[i]) == "--restore") restorePath = argv[i + 1];
+    }
+    if (restorePath)
+    {
+        size = snapshotBoardSize(restorePath);
+        if (size <= 0)
+        {
+            std::cout << "Couldn't read snapshot: " << restorePath << std::endl;
+            return -1;
+        }
+    }
+
+    Simulation sim(size);
+    sim.setKernel(Simulation::detectKernel());
+
+    bool useHashLife = false;
+    bool useSparse = false;
+    const char* patternPath = nullptr;
+    const char* populationsPath = nullptr;
+    const char* snapshotOutPath = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--pattern" && i + 1 < argc) patternPath = argv[++i];
+        else if (std::string(argv[i]) == "--restore" && i + 1 < argc) i++;    //handled above
+        else if (std::string(argv[i]) == "--populations" && i + 1 < argc) populationsPath = argv[++i];
+        else if (std::string(argv[i]) == "--snapshot" && i + 1 < argc) snapshotOutPath = argv[++i];
+        else if (std::string(argv[i]) == "--hashlife") useHashLife = true;
+        else if (std::string(argv[i]) == "--sparse") useSparse = true;
+        else if (std::string(argv[i]) == "--bits") sim.setKernel(Kernel::Bitwise);
+        else if (std::string(argv[i]) == "--fused" && i + 1 < argc)
+        {
+            //Fusion only exists on the bit-packed path, so the flag implies it.
+            sim.setKernel(Kernel::Bitwise);
+            sim.setFusedSteps(atoi(argv[++i]));
+        }
+        else if (std::string(argv[i]) == "--scalar") sim.setKernel(Kernel::Scalar);
+        else if (std::string(argv[i]) == "--incremental") sim.setIncremental(true);
+        else if (std::string(argv[i]) == "--torus") sim.setTopology(Topology::Torus);
+        else if (std::string(argv[i]) == "--threads" && i + 1 < argc)
+        {
+            sim.setThreadCount(atoi(argv[++i]));
+        }
+    }
+
+    if (restorePath)
+    {
+        if (!loadSnapshot(restorePath, sim)) return -1;
+    }
+    else if (patternPath)
+    {
+        if (!loadRlePattern(patternPath, sim))
+        {
+            std::cout << "Couldn't load pattern: " << patternPath << std::endl;
+            return -1;
+        }
+    }
+    else
+    {
+        fillRandom(sim, 1234);
+    }
+
+    FILE* populations = nullptr;
+    if (populationsPath)
+    {
+        populations = fopen(populationsPath, "w");
+        if (!populations)
+        {
+            std::cout << "Couldn't open populations CSV: " << populationsPath << std::endl;
+            return -1;
+        }
+        fprintf(populations, "generation,population\n");
+    }
+
+    size_t sparseTiles = 0;
+    std::uint64_t arenaAllocations = 0, arenaHits = 0;
+    size_t arenaReserved = 0;
+    int generationsRun = generations;
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (useHashLife)
+    {
+        HashLife hashLife(size);
+        hashLife.loadFrom(sim);
+        hashLife.run(generations);
+        hashLife.writeTo(sim);
+        //writeTo only copies cells; carry the engine's counter over so a
+        //--snapshot-out header doesn't claim generation 0.
+        sim.setGeneration(sim.getGeneration() + hashLife.getGeneration());
+    }
+    else if (useSparse)
+    {
+        SparseWorld world;
+        world.loadFrom(sim);
+        world.run(generations);
+        sparseTiles = world.getTileCount();
+        arenaAllocations = world.getArena().getAllocations();
+        arenaHits = world.getArena().getFreelistHits();
+        arenaReserved = world.getArena().getReservedBytes();
+        world.writeTo(sim);
+        sim.setGeneration(sim.getGeneration() + world.getGeneration());
+    }
+    else
+    {
+        //A fused update advances sim.getFusedSteps() generations at once;
+        //when that doesn't divide the request the last update overshoots.
+        //Round up explicitly and report what actually ran.
+        int updates = (generations + sim.getFusedSteps() - 1) / sim.getFusedSteps();
+        generationsRun = updates * sim.getFusedSteps();
+        for (int u = 0; u < updates; u++)
+        {
+            sim.update();
+            if (populations)
+            {
+                //Maintained by the kernel, so logging every generation is free.
+                fprintf(populations, "%llu,%llu\n",
+                    (unsigned long long)sim.getGeneration(),
+                    (unsigned long long)sim.getPopulation());
+            }
+        }
+    }
+
+    //The fast-forward engines only have the final state to report.
+    if (populations && (useHashLife || useSparse))
+    {
+        fprintf(populations, "%d,%llu\n", generations, (unsigned long long)sim.getPopulation());
+    }
+    if (populations) fclose(populations);
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    double cellUpdates = (double)generationsRun * size * size;
+
+    std::cout << "board:            " << size << "x" << size << std::endl;
+    std::cout << "kernel:           "
+              << (useHashLife ? "hashlife" : useSparse ? "sparse" : kernelName(sim.getKernel()));
+    if (!useHashLife && !useSparse && sim.getFusedSteps() > 1)
+    {
+        std::cout << " (fused x" << sim.getFusedSteps() << ")";
+    }
+    std::cout << ", " << sim.getThreadCount() << " thread(s)" << std::endl;
+    if (useSparse) std::cout << "tiles:            " << sparseTiles << std::endl;
+    if (useSparse && arenaAllocations)
+    {
+        //How often a tile came off the freelist instead of bumping the arena.
+        std::cout << "arena:            " << arenaAllocations << " allocs, "
+                  << (100.0 * arenaHits / arenaAllocations) << "% freelist hits, "
+                  << arenaReserved / 1024 << " KiB reserved" << std::endl;
+    }
+    std::cout << "generations:      " << generationsRun << std::endl;
+    std::cout << "wall time:        " << seconds << " s" << std::endl;
+    std::cout << "generations/sec:  " << generationsRun / seconds << std::endl;
+    std::cout << "cell-updates/sec: " << cellUpdates / seconds << std::endl;
+    std::cout << "population:       " << sim.getPopulation() << std::endl;
+
+    if (snapshotOutPath && !saveSnapshot(snapshotOutPath, sim)) return -1;
+
+    return 0;
+}